@@ -0,0 +1,138 @@
+#include <raylib.h>
+
+#include "draw_list.h"
+#include "runtime.h"
+
+// Screen constants
+#define SCREEN_TITLE  "Arcade"
+#define SCREEN_WIDTH  800
+#define SCREEN_HEIGHT 600
+
+// -------------------------------------------------------------------------------------
+// Enumerations
+// -------------------------------------------------------------------------------------
+typedef enum {
+    SCREEN_NONE = 0,
+    SCREEN_MENU,
+    SCREEN_COUNT
+} ScreenState;
+
+// -------------------------------------------------------------------------------------
+// Globals
+// -------------------------------------------------------------------------------------
+// Games, pong.c and snake.c built with ARCADE defined leave out their entrypoints
+extern const Game pongGame, snakeGame;
+
+// Screens
+static DrawList drawList;
+
+// Menu screen, the games it switches to
+static const Game *games[] = {&pongGame, &snakeGame};
+static int menuOption;
+static bool debugMode;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+// Screen management, the window and the fades are the runtime's
+static Screen CreateScreen(int screenState);
+
+// Menu screen
+static void InitMenuScreen(void);
+static void UpdateMenuScreen(float dt);
+static void RenderMenuScreen(float fading);
+
+// Helper functions
+static void InitAssets(void);
+static void DestroyAssets(void);
+
+// -------------------------------------------------------------------------------------
+// Game module, the one the others go back to once they close
+// -------------------------------------------------------------------------------------
+static const Game arcadeGame = {.name = SCREEN_TITLE,
+                                .width = SCREEN_WIDTH,
+                                .height = SCREEN_HEIGHT,
+                                .createScreen = &CreateScreen,
+                                .firstScreen = SCREEN_MENU,
+                                .loadAssets = &InitAssets,
+                                .unloadAssets = &DestroyAssets,
+                                .pollAssets = NULL,
+                                .endFrame = NULL,
+                                .drawList = &drawList,
+                                .debugMode = &debugMode};
+
+// -------------------------------------------------------------------------------------
+// Entrypoint
+// -------------------------------------------------------------------------------------
+int main(void) {
+// pre configuration
+#if defined(DEBUG)
+    SetTraceLogLevel(LOG_DEBUG);
+#else
+    SetTraceLogLevel(LOG_NONE);
+#endif
+
+    // one window and audio device for every game, their assets load once
+    RunGame(&arcadeGame, SCREEN_MENU, 60);
+
+    return 0;
+}
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static Screen CreateScreen(int screenState) {
+    Screen screen = {0};
+
+    if (screenState == SCREEN_MENU) {
+        screen.init = &InitMenuScreen;
+        screen.update = &UpdateMenuScreen;
+        screen.render = &RenderMenuScreen;
+        screen.updateZone = "UpdateMenuScreen";
+        screen.renderZone = "RenderMenuScreen";
+    }
+
+    return screen;
+}
+
+static void InitMenuScreen(void) { TraceLog(LOG_DEBUG, "Arcade menu"); }
+
+static void UpdateMenuScreen(float dt) {
+    (void)dt;
+    int gameCount = sizeof(games) / sizeof(const Game *);
+
+    if (IsKeyPressed(KEY_ESCAPE)) {
+        SetNextScreen(SCREEN_NONE);
+    }
+    if (IsKeyPressed(KEY_ENTER)) {
+        SwitchGame(games[menuOption]);
+    }
+    if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_W)) {
+        menuOption = (menuOption == 0) ? gameCount - 1 : menuOption - 1;
+    }
+    if (IsKeyPressed(KEY_DOWN) || IsKeyPressed(KEY_S)) {
+        menuOption = (menuOption == gameCount - 1) ? 0 : menuOption + 1;
+    }
+    if (IsKeyPressed(KEY_D)) {
+        debugMode = !debugMode;
+    }
+}
+
+static void RenderMenuScreen(float fading) {
+    int titleMeasure = DrawListMeasureText(&drawList, "ARCADE", 96);
+    DrawListText(&drawList, "ARCADE", (SCREEN_WIDTH - titleMeasure) / 2.0f, 150, 96,
+                 Fade(WHITE, fading));
+
+    int gameCount = sizeof(games) / sizeof(const Game *);
+    for (int i = 0; i < gameCount; ++i) {
+        const char *name = TextToUpper(games[i]->name);
+        int nameMeasure = DrawListMeasureText(&drawList, name, 24);
+        Color color = i == menuOption ? WHITE : GRAY;
+        DrawListText(&drawList, name, (SCREEN_WIDTH - nameMeasure) / 2.0f,
+                     360 + 40 * i, 24, Fade(color, fading));
+    }
+}
+
+static void InitAssets(void) { drawList = CreateDrawList(NULL); }
+
+static void DestroyAssets(void) { DestroyDrawList(&drawList); }
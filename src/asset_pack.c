@@ -0,0 +1,259 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "asset_pack.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "tick.h"
+
+static const unsigned char packMagic[4] = {'A', 'P', 'A', 'K'};
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static void PutU16(unsigned char *bytes, unsigned int value) {
+    bytes[0] = value & 0xff;
+    bytes[1] = (value >> 8) & 0xff;
+}
+
+static void PutU32(unsigned char *bytes, unsigned int value) {
+    PutU16(bytes, value & 0xffff);
+    PutU16(bytes + 2, value >> 16);
+}
+
+static unsigned int GetU16(const unsigned char *bytes) {
+    return bytes[0] | (unsigned int)bytes[1] << 8;
+}
+
+static unsigned int GetU32(const unsigned char *bytes) {
+    return GetU16(bytes) | GetU16(bytes + 2) << 16;
+}
+
+static unsigned int HashBytes(const unsigned char *bytes, size_t size) {
+    // FNV-1a, reading it is also what faults the pages in
+    unsigned int hash = 0x811c9dc5u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x01000193u;
+    }
+    return hash;
+}
+
+static bool ValidWaveFormat(Wave wave) {
+    // the sample sizes raylib plays, a wave without channels has nothing to play
+    return wave.channels > 0 &&
+           (wave.sampleSize == 8 || wave.sampleSize == 16 || wave.sampleSize == 32);
+}
+
+static unsigned long long EntryDataSize(const AssetEntry *entry) {
+    // in 64 bits, the 32 bit fields of a damaged index can't wrap it below the size
+    return (unsigned long long)entry->wave.frameCount * entry->wave.channels *
+           (entry->wave.sampleSize / 8);
+}
+
+static void *LoaderMain(void *arg) {
+    AssetPack *pack = arg;
+
+    int validCount = 0;
+    for (int i = 0; i < pack->entryCount; ++i) {
+        AssetEntry *entry = &pack->entries[i];
+        const unsigned char *bytes = pack->data + entry->offset;
+        entry->valid = HashBytes(bytes, entry->size) == entry->hash;
+        validCount += entry->valid;
+    }
+
+    pthread_mutex_lock(&pack->lock);
+    pack->validCount = validCount;
+    pack->loadTime = GetSeconds() - pack->openTime;
+    pack->loaded = true;
+    pthread_mutex_unlock(&pack->lock);
+
+    return NULL;
+}
+
+AssetPack OpenAssetPack(const char *path) {
+    AssetPack pack = {0};
+    pack.openTime = GetSeconds();
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return pack;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < ASSET_PACK_HEADER_SIZE) {
+        close(fd);
+        return pack;
+    }
+
+    // the mapping outlives the descriptor, the loader thread pages the data in
+    void *data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return pack;
+    }
+
+    const unsigned char *bytes = data;
+    size_t size = info.st_size;
+    int entryCount = GetU16(bytes + 6);
+    size_t indexEnd = ASSET_PACK_HEADER_SIZE + entryCount * ASSET_PACK_ENTRY_SIZE;
+    if (memcmp(bytes, packMagic, sizeof(packMagic)) != 0 ||
+        GetU16(bytes + 4) != ASSET_PACK_VERSION || GetU32(bytes + 8) != size ||
+        entryCount > ASSET_PACK_ENTRIES_MAX || indexEnd > size) {
+        munmap(data, size);
+        return pack;
+    }
+
+    // an entry past the end of the file, bigger than its samples or in a sample format
+    // raylib can't play is left out
+    for (int i = 0; i < entryCount; ++i) {
+        const unsigned char *index = bytes + ASSET_PACK_HEADER_SIZE +
+                                     i * ASSET_PACK_ENTRY_SIZE;
+        AssetEntry entry = {0};
+        memcpy(entry.name, index, ASSET_NAME_SIZE - 1);
+        entry.type = GetU16(index + 24);
+        entry.wave.channels = GetU16(index + 26);
+        entry.wave.sampleRate = GetU32(index + 28);
+        entry.wave.sampleSize = GetU32(index + 32);
+        entry.wave.frameCount = GetU32(index + 36);
+        entry.offset = GetU32(index + 40);
+        entry.size = GetU32(index + 44);
+        entry.hash = GetU32(index + 48);
+        if (entry.offset < indexEnd || entry.offset > size ||
+            entry.size > size - entry.offset ||
+            (entry.type == ASSET_SOUND && (!ValidWaveFormat(entry.wave) ||
+                                           EntryDataSize(&entry) > entry.size))) {
+            continue;
+        }
+        entry.wave.data = (void *)(bytes + entry.offset);
+        pack.entries[pack.entryCount++] = entry;
+    }
+
+    pack.data = bytes;
+    pack.size = size;
+
+    return pack;
+}
+
+bool StartAssetPack(AssetPack *pack) {
+    if (pack->data == NULL) {
+        return false;
+    }
+
+    pthread_mutex_init(&pack->lock, NULL);
+    posix_madvise((void *)pack->data, pack->size, POSIX_MADV_WILLNEED);
+    pack->started = pthread_create(&pack->thread, NULL, LoaderMain, pack) == 0;
+    if (!pack->started) {
+        // no thread, the caller's thread pages it in instead
+        LoaderMain(pack);
+    }
+    return pack->started;
+}
+
+void DestroyAssetPack(AssetPack *pack) {
+    if (pack->started && !pack->joined) {
+        pthread_join(pack->thread, NULL);
+    }
+    if (pack->started) {
+        pthread_mutex_destroy(&pack->lock);
+    }
+    if (pack->data != NULL) {
+        munmap((void *)pack->data, pack->size);
+    }
+
+    pack->data = NULL;
+    pack->size = 0;
+    pack->entryCount = 0;
+    pack->started = false;
+    pack->loaded = false;
+    pack->joined = false;
+}
+
+bool AssetPackLoaded(AssetPack *pack) {
+    // never blocks, the thread is joined once it has said it is done
+    if (!pack->started) {
+        return pack->loaded;
+    }
+
+    pthread_mutex_lock(&pack->lock);
+    bool loaded = pack->loaded;
+    pthread_mutex_unlock(&pack->lock);
+    if (loaded && !pack->joined) {
+        pthread_join(pack->thread, NULL);
+        pack->joined = true;
+    }
+    return loaded;
+}
+
+const AssetEntry *AssetPackFind(const AssetPack *pack, const char *name,
+                                AssetType type) {
+    if (!pack->loaded) {
+        return NULL;
+    }
+    for (int i = 0; i < pack->entryCount; ++i) {
+        const AssetEntry *entry = &pack->entries[i];
+        if (entry->valid && entry->type == type &&
+            strncmp(entry->name, name, ASSET_NAME_SIZE) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+bool WriteAssetPack(const char *path, const AssetEntry *entries, int count) {
+    if (count > ASSET_PACK_ENTRIES_MAX) {
+        return false;
+    }
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+
+    // the data follows the index, every entry aligned so the samples can be read
+    // straight from the mapping
+    static const unsigned char padding[ASSET_PACK_ALIGN] = {0};
+    unsigned int offsets[ASSET_PACK_ENTRIES_MAX];
+    unsigned int end = ASSET_PACK_HEADER_SIZE + count * ASSET_PACK_ENTRY_SIZE;
+    for (int i = 0; i < count; ++i) {
+        end = (end + ASSET_PACK_ALIGN - 1) / ASSET_PACK_ALIGN * ASSET_PACK_ALIGN;
+        offsets[i] = end;
+        end += entries[i].size;
+    }
+
+    unsigned char header[ASSET_PACK_HEADER_SIZE];
+    memcpy(header, packMagic, sizeof(packMagic));
+    PutU16(header + 4, ASSET_PACK_VERSION);
+    PutU16(header + 6, count);
+    PutU32(header + 8, end);
+    bool written = fwrite(header, 1, sizeof(header), file) == sizeof(header);
+
+    for (int i = 0; i < count; ++i) {
+        const AssetEntry *entry = &entries[i];
+        unsigned char index[ASSET_PACK_ENTRY_SIZE] = {0};
+        strncpy((char *)index, entry->name, ASSET_NAME_SIZE - 1);
+        PutU16(index + 24, entry->type);
+        PutU16(index + 26, entry->wave.channels);
+        PutU32(index + 28, entry->wave.sampleRate);
+        PutU32(index + 32, entry->wave.sampleSize);
+        PutU32(index + 36, entry->wave.frameCount);
+        PutU32(index + 40, offsets[i]);
+        PutU32(index + 44, entry->size);
+        PutU32(index + 48, HashBytes(entry->wave.data, entry->size));
+        written = written && fwrite(index, 1, sizeof(index), file) == sizeof(index);
+    }
+
+    unsigned int position = ASSET_PACK_HEADER_SIZE + count * ASSET_PACK_ENTRY_SIZE;
+    for (int i = 0; i < count; ++i) {
+        written = written && fwrite(padding, 1, offsets[i] - position, file) ==
+                                 offsets[i] - position;
+        written = written && fwrite(entries[i].wave.data, 1, entries[i].size, file) ==
+                                 entries[i].size;
+        position = offsets[i] + entries[i].size;
+    }
+
+    return fclose(file) == 0 && written;
+}
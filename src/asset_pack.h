@@ -0,0 +1,71 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <pthread.h>
+#include <raylib.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// File layout, all integers little endian:
+//   header  magic "APAK", u16 version, u16 entry count, u32 file size
+//   index   per entry: char name[24], u16 type, u16 channels, u32 sample rate,
+//           u32 sample size, u32 frame count, u32 offset, u32 size, u32 hash
+//   data    the entries, each at an offset aligned to ASSET_PACK_ALIGN
+#define ASSET_PACK_VERSION     1
+#define ASSET_PACK_HEADER_SIZE 12
+#define ASSET_PACK_ENTRY_SIZE  52
+#define ASSET_PACK_ALIGN       16
+#define ASSET_NAME_SIZE        24
+#define ASSET_PACK_ENTRIES_MAX 64
+
+// Where the games look for it, next to their binary
+#define ASSET_PACK_FILE "assets.pack"
+
+// -------------------------------------------------------------------------------------
+// Enumerations
+// -------------------------------------------------------------------------------------
+typedef enum {
+    ASSET_SOUND = 1 // PCM decoded by the packer, interleaved as a raylib Wave holds it
+} AssetType;
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+typedef struct AssetEntry {
+    char name[ASSET_NAME_SIZE]; // file name without its extension
+    AssetType type;
+    Wave wave;                       // sounds, the samples point into the mapping
+    unsigned int offset, size, hash; // FNV-1a of the data
+    bool valid;                      // checked by the loader
+} AssetEntry;
+
+// Assets packed in one file by pack_assets. Opening it maps the file and reads the
+// index, nothing else, so it costs the same whatever the pack holds. A loader thread
+// then pages the data in and checks every entry while the first screen runs; the
+// entries are handed out once it is done, without copying them out of the mapping.
+typedef struct AssetPack {
+    const unsigned char *data; // the mapped file
+    size_t size;
+    AssetEntry entries[ASSET_PACK_ENTRIES_MAX];
+    int entryCount;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    bool started, loaded, joined;
+    int validCount;  // entries whose data matches their hash
+    double openTime; // when it was mapped
+    double loadTime; // seconds from the mapping to the loader finishing
+} AssetPack;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+AssetPack OpenAssetPack(const char *path);
+bool StartAssetPack(AssetPack *pack);
+void DestroyAssetPack(AssetPack *pack);
+bool AssetPackLoaded(AssetPack *pack);
+const AssetEntry *AssetPackFind(const AssetPack *pack, const char *name,
+                                AssetType type);
+bool WriteAssetPack(const char *path, const AssetEntry *entries, int count);
+
+#endif // ASSET_PACK_H
@@ -0,0 +1,247 @@
+#include "audio_mixer.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tick.h"
+
+// Fade at both ends of a synthesized beep, in seconds, so it doesn't click
+#define MIXER_SYNTH_RAMP 0.002f
+
+// The stream callback has no user pointer, one mixer plays at a time
+static AudioMixer *activeMixer;
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static int CompareFloat(const void *a, const void *b) {
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+static float *ReserveClip(AudioMixer *mixer, int frameCount, float sampleRate) {
+    if (mixer->storage == NULL || mixer->clipCount == MIXER_CLIPS_MAX ||
+        frameCount < 2 || frameCount > MIXER_STORAGE_FRAMES - mixer->storageUsed) {
+        return NULL;
+    }
+
+    float *samples = mixer->storage + mixer->storageUsed;
+    mixer->storageUsed += frameCount;
+    mixer->clips[mixer->clipCount] = (MixerClip){
+        .samples = samples, .frameCount = frameCount, .sampleRate = sampleRate};
+    return samples;
+}
+
+static void StartVoice(AudioMixer *mixer, const MixerTrigger *trigger, double heard) {
+    // a free voice, or the one that started first
+    MixerVoice *voice = &mixer->voices[0];
+    for (int i = 0; i < MIXER_VOICES; ++i) {
+        MixerVoice *candidate = &mixer->voices[i];
+        if (candidate->clip == NULL) {
+            voice = candidate;
+            break;
+        }
+        if (candidate->serial < voice->serial) {
+            voice = candidate;
+        }
+    }
+    mixer->stolenCount += voice->clip != NULL;
+
+    const MixerClip *clip = &mixer->clips[trigger->clip];
+    voice->clip = clip;
+    voice->position = 0.0f;
+    voice->step = trigger->pitch * clip->sampleRate / MIXER_SAMPLE_RATE;
+    voice->gainLeft = trigger->gainLeft;
+    voice->gainRight = trigger->gainRight;
+    voice->serial = ++mixer->serial;
+
+    mixer->latencies[mixer->latencyCount++ % MIXER_LATENCY_SAMPLES] =
+        heard - trigger->time;
+    ++mixer->startedCount;
+}
+
+static void MixVoice(MixerVoice *voice, float *out, unsigned int frames) {
+    // linear interpolation between the clip frames around the position
+    const float *samples = voice->clip->samples;
+    int last = voice->clip->frameCount - 1;
+    for (unsigned int i = 0; i < frames; ++i) {
+        int index = (int)voice->position;
+        if (index >= last) {
+            voice->clip = NULL;
+            return;
+        }
+        float amount = voice->position - index;
+        float sample = samples[index] + (samples[index + 1] - samples[index]) * amount;
+        out[2 * i] += sample * voice->gainLeft;
+        out[2 * i + 1] += sample * voice->gainRight;
+        voice->position += voice->step;
+    }
+}
+
+static void MixerCallback(void *buffer, unsigned int frames) {
+    AudioMixer *mixer = activeMixer;
+    float *out = buffer;
+    memset(out, 0, frames * 2 * sizeof(float));
+    if (mixer == NULL) {
+        return;
+    }
+
+    // the sounds queued since the last period start at the top of this one, which
+    // is heard once the period already queued ahead of it has played
+    double heard = GetSeconds() + (double)frames / MIXER_SAMPLE_RATE;
+    unsigned int head = __atomic_load_n(&mixer->head, __ATOMIC_ACQUIRE);
+    for (unsigned int tail = mixer->tail; tail != head; ++tail) {
+        StartVoice(mixer, &mixer->triggers[tail & (MIXER_QUEUE_SIZE - 1)], heard);
+    }
+    __atomic_store_n(&mixer->tail, head, __ATOMIC_RELEASE);
+
+    for (int i = 0; i < MIXER_VOICES; ++i) {
+        if (mixer->voices[i].clip != NULL) {
+            MixVoice(&mixer->voices[i], out, frames);
+        }
+    }
+    for (unsigned int i = 0; i < 2 * frames; ++i) {
+        out[i] = fminf(fmaxf(out[i], -1.0f), 1.0f);
+    }
+}
+
+AudioMixer CreateAudioMixer(void) {
+    AudioMixer mixer = {0};
+    // without storage every clip fails to load and the mixer stays silent
+    mixer.storage = malloc(MIXER_STORAGE_FRAMES * sizeof(float));
+    return mixer;
+}
+
+bool StartAudioMixer(AudioMixer *mixer) {
+    // the device must be open, the period size only applies to this stream
+    if (activeMixer != NULL || !IsAudioDeviceReady()) {
+        return false;
+    }
+
+    SetAudioStreamBufferSizeDefault(MIXER_PERIOD_FRAMES);
+    mixer->stream = LoadAudioStream(MIXER_SAMPLE_RATE, 32, 2);
+    SetAudioStreamBufferSizeDefault(0);
+
+    activeMixer = mixer;
+    SetAudioStreamCallback(mixer->stream, MixerCallback);
+    PlayAudioStream(mixer->stream);
+    mixer->playing = true;
+    return true;
+}
+
+void DestroyAudioMixer(AudioMixer *mixer) {
+    if (mixer->playing) {
+        StopAudioStream(mixer->stream);
+        UnloadAudioStream(mixer->stream);
+        activeMixer = NULL;
+        mixer->playing = false;
+    }
+
+    free(mixer->storage);
+    mixer->storage = NULL;
+    mixer->storageUsed = 0;
+    mixer->clipCount = 0;
+}
+
+int MixerAddWave(AudioMixer *mixer, Wave wave) {
+    // 8 bit unsigned, 16 bit signed or 32 bit float as raylib loads them, averaged
+    // down to mono
+    if (wave.channels == 0 ||
+        (wave.sampleSize != 8 && wave.sampleSize != 16 && wave.sampleSize != 32)) {
+        return -1;
+    }
+    float *samples = ReserveClip(mixer, wave.frameCount, wave.sampleRate);
+    if (samples == NULL) {
+        return -1;
+    }
+
+    for (unsigned int frame = 0; frame < wave.frameCount; ++frame) {
+        float sum = 0.0f;
+        for (unsigned int channel = 0; channel < wave.channels; ++channel) {
+            unsigned int i = frame * wave.channels + channel;
+            if (wave.sampleSize == 8) {
+                sum += (((const unsigned char *)wave.data)[i] - 128) / 128.0f;
+            } else if (wave.sampleSize == 16) {
+                sum += ((const short *)wave.data)[i] / 32768.0f;
+            } else {
+                sum += ((const float *)wave.data)[i];
+            }
+        }
+        samples[frame] = sum / wave.channels;
+    }
+
+    return mixer->clipCount++;
+}
+
+int MixerSynthSquare(AudioMixer *mixer, float frequency, float duration, float volume) {
+    int frameCount = duration * MIXER_SAMPLE_RATE;
+    float *samples = ReserveClip(mixer, frameCount, MIXER_SAMPLE_RATE);
+    if (samples == NULL) {
+        return -1;
+    }
+
+    // a linear ramp in and out, the rest held at the volume
+    float period = MIXER_SAMPLE_RATE / frequency;
+    float rampFrames = MIXER_SYNTH_RAMP * MIXER_SAMPLE_RATE;
+    for (int i = 0; i < frameCount; ++i) {
+        float phase = fmodf(i, period) / period;
+        float envelope = fminf(fminf(i, frameCount - 1 - i) / rampFrames, 1.0f);
+        samples[i] = (phase < 0.5f ? volume : -volume) * envelope;
+    }
+
+    return mixer->clipCount++;
+}
+
+bool MixerPlay(AudioMixer *mixer, int clip, float pitch, float pan, float gain) {
+    // the acquire pairs with the callback release, the slot is free once tail moved
+    unsigned int head = mixer->head;
+    unsigned int tail = __atomic_load_n(&mixer->tail, __ATOMIC_ACQUIRE);
+    if (!mixer->playing || clip < 0 || clip >= mixer->clipCount) {
+        return false;
+    }
+    if (head - tail == MIXER_QUEUE_SIZE) {
+        ++mixer->droppedCount;
+        return false;
+    }
+
+    // constant power panning, pan goes from -1 on the left to 1 on the right
+    float angle = (fminf(fmaxf(pan, -1.0f), 1.0f) + 1.0f) * PI / 4.0f;
+    mixer->triggers[head & (MIXER_QUEUE_SIZE - 1)] =
+        (MixerTrigger){.clip = clip,
+                       .pitch = pitch,
+                       .gainLeft = gain * cosf(angle),
+                       .gainRight = gain * sinf(angle),
+                       .time = GetSeconds()};
+    __atomic_store_n(&mixer->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+void MixerReport(const AudioMixer *mixer) {
+    int count = mixer->latencyCount < MIXER_LATENCY_SAMPLES ? mixer->latencyCount
+                                                            : MIXER_LATENCY_SAMPLES;
+    if (count == 0) {
+        printf("audio latency: no sounds reached the mixer\n");
+        return;
+    }
+
+    float *sorted = malloc(count * sizeof(float));
+    if (sorted == NULL) {
+        printf("audio latency: no memory to sort %d sounds\n", count);
+        return;
+    }
+    memcpy(sorted, mixer->latencies, count * sizeof(float));
+    qsort(sorted, count, sizeof(float), CompareFloat);
+
+    printf("audio latency (%d sounds): p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, "
+           "max %.2f ms\n",
+           count, 1000.0f * sorted[(int)(0.50f * (count - 1))],
+           1000.0f * sorted[(int)(0.90f * (count - 1))],
+           1000.0f * sorted[(int)(0.99f * (count - 1))], 1000.0f * sorted[count - 1]);
+    printf("audio mixer: %d sounds, %d voices stolen, %d dropped, %.1f ms periods\n",
+           mixer->startedCount, mixer->stolenCount, mixer->droppedCount,
+           1000.0f * MIXER_PERIOD_FRAMES / MIXER_SAMPLE_RATE);
+
+    free(sorted);
+}
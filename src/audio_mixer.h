@@ -0,0 +1,88 @@
+#ifndef AUDIO_MIXER_H
+#define AUDIO_MIXER_H
+
+#include <raylib.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Output stream, stereo floats. The device asks for a period at a time, a sound
+// queued by the game starts at the latest one period later.
+#define MIXER_SAMPLE_RATE   44100
+#define MIXER_PERIOD_FRAMES 256
+
+// Sounds playing at once, the oldest one is cut short for a new one
+#define MIXER_VOICES 16
+
+// Clips and their mono samples, allocated once when the mixer is created
+#define MIXER_CLIPS_MAX      16
+#define MIXER_STORAGE_FRAMES (MIXER_SAMPLE_RATE * 4)
+
+// Sounds waiting for the next period, a power of two
+#define MIXER_QUEUE_SIZE 256
+
+// Latencies kept for the percentiles, the most recent ones
+#define MIXER_LATENCY_SAMPLES 4096
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+typedef struct MixerClip {
+    const float *samples; // mono, in the mixer storage
+    int frameCount;
+    float sampleRate;
+} MixerClip;
+
+typedef struct MixerTrigger {
+    int clip;
+    float pitch; // playback rate, 1 plays the clip as it is
+    float gainLeft, gainRight;
+    double time; // when the game queued it
+} MixerTrigger;
+
+typedef struct MixerVoice {
+    const MixerClip *clip; // NULL when free
+    float position, step;  // in clip frames
+    float gainLeft, gainRight;
+    unsigned int serial; // order the voices started in, the lowest is stolen
+} MixerVoice;
+
+// Voice pool mixed by the audio device thread through a raylib AudioStream callback.
+// The game queues sounds through a lock-free ring; the callback starts them at the
+// top of the next period and mixes every voice with its own pitch and pan. Clips
+// are converted or synthesized into storage allocated up front, so nothing in the
+// callback allocates or locks.
+typedef struct AudioMixer {
+    AudioStream stream;
+    bool playing;
+    float *storage; // every clip's samples
+    int storageUsed;
+    MixerClip clips[MIXER_CLIPS_MAX];
+    int clipCount;
+
+    unsigned int head; // next trigger to write, owned by the game
+    MixerTrigger triggers[MIXER_QUEUE_SIZE];
+    unsigned int tail; // next trigger to start, owned by the callback
+
+    // callback side
+    MixerVoice voices[MIXER_VOICES];
+    unsigned int serial;
+    int startedCount, stolenCount;
+    float latencies[MIXER_LATENCY_SAMPLES]; // seconds from the queue to the output
+    int latencyCount;
+
+    // game side
+    int droppedCount; // queue full, the callback stopped or is falling behind
+} AudioMixer;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+AudioMixer CreateAudioMixer(void);
+bool StartAudioMixer(AudioMixer *mixer);
+void DestroyAudioMixer(AudioMixer *mixer);
+int MixerAddWave(AudioMixer *mixer, Wave wave);
+int MixerSynthSquare(AudioMixer *mixer, float frequency, float duration, float volume);
+bool MixerPlay(AudioMixer *mixer, int clip, float pitch, float pan, float gain);
+void MixerReport(const AudioMixer *mixer);
+
+#endif // AUDIO_MIXER_H
@@ -0,0 +1,272 @@
+#include "ball_pool.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static float RandomUnit(BallPool *pool) {
+    // xorshift32, same generator as the match so runs are reproducible
+    unsigned int x = pool->rngState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    pool->rngState = x;
+
+    return (x % 1001) / 1000.0f;
+}
+
+static void ServeBall(BallPool *pool, int i) {
+    float dirX = RandomUnit(pool) < 0.5f ? -1.0f : 1.0f;
+    float dirY = 2.0f * RandomUnit(pool) - 1.0f;
+    float length = sqrtf(dirX * dirX + dirY * dirY);
+
+    pool->x[i] = pool->prevX[i] = (SCREEN_WIDTH - BALL_WIDTH) / 2.0f;
+    pool->y[i] = pool->prevY[i] = (SCREEN_HEIGHT - BALL_HEIGHT) / 2.0f;
+    pool->dirX[i] = dirX / length;
+    pool->dirY[i] = dirY / length;
+    pool->speed[i] = BALL_INITIAL_SPEED;
+    pool->hitCounter[i] = 0;
+}
+
+static CollisionData BatchedPaddleHit(const BallPool *pool, int r, Rectangle ball,
+                                      Entity paddle, Vector2 vel) {
+    // the batch skips the broad check SweepBallPaddle makes, its hit has to pass it
+    const SweptResults *results = &pool->results;
+    CollisionData collData = {.time = 1.0f};
+    if (results->hit[r] && AABBCheck(SweptRectangle(ball, vel), paddle.rect)) {
+        collData.hit = true;
+        collData.time = results->time[r];
+        collData.contactPoint = (Vector2){results->contactX[r], results->contactY[r]};
+        collData.contactNormal = (Vector2){results->normalX[r], results->normalY[r]};
+    }
+    return collData;
+}
+
+static void BouncePaddle(BallPool *pool, int i, Entity paddle, CollisionData collData) {
+    pool->x[i] = collData.contactPoint.x;
+    pool->y[i] = collData.contactPoint.y;
+
+    if (collData.contactNormal.x == 0) {
+        // colided from top or bottom
+        pool->dirY[i] *= -1.0f;
+    } else {
+        // collided from the front
+        float dirX = -pool->dirX[i];
+        float dirY = (2 * (pool->y[i] - paddle.rect.y + BALL_HEIGHT) /
+                      (PADDLE_HEIGHT + BALL_HEIGHT)) -
+                     1.0f;
+        float length = sqrtf(dirX * dirX + dirY * dirY);
+        pool->dirX[i] = dirX / length;
+        pool->dirY[i] = dirY / length;
+    }
+
+    float speed =
+        BALL_INITIAL_SPEED + BALL_SPEED_INCREMENT * sqrtf(++pool->hitCounter[i]);
+    pool->speed[i] = fminf(speed, BALL_POOL_SPEED_MAX);
+}
+
+static void BounceWall(BallPool *pool, int i, CollisionData collData) {
+    // bricks and borders only turn the ball back
+    pool->x[i] = collData.contactPoint.x;
+    pool->y[i] = collData.contactPoint.y;
+    if (collData.contactNormal.x == 0) {
+        pool->dirY[i] *= -1.0f;
+    } else {
+        pool->dirX[i] *= -1.0f;
+    }
+}
+
+BallPool CreateBallPool(int capacity, unsigned int seed) {
+    BallPool pool = {0};
+    size_t size = capacity * sizeof(float);
+
+    pool.capacity = capacity;
+    pool.rngState = seed != 0 ? seed : 0x9e3779b9u;
+    pool.x = malloc(size);
+    pool.y = malloc(size);
+    pool.prevX = malloc(size);
+    pool.prevY = malloc(size);
+    pool.dirX = malloc(size);
+    pool.dirY = malloc(size);
+    pool.speed = malloc(size);
+    pool.hitCounter = malloc(capacity * sizeof(int));
+    pool.hits = malloc(capacity * sizeof(int));
+    pool.width = malloc(size);
+    pool.height = malloc(size);
+    pool.velX = malloc(size);
+    pool.velY = malloc(size);
+
+    // one result per ball for each paddle
+    pool.results.hit = malloc(2 * capacity * sizeof(int));
+    pool.results.time = malloc(2 * size);
+    pool.results.contactX = malloc(2 * size);
+    pool.results.contactY = malloc(2 * size);
+    pool.results.normalX = malloc(2 * size);
+    pool.results.normalY = malloc(2 * size);
+
+    if (pool.x == NULL || pool.y == NULL || pool.prevX == NULL || pool.prevY == NULL ||
+        pool.dirX == NULL || pool.dirY == NULL || pool.speed == NULL ||
+        pool.hitCounter == NULL || pool.hits == NULL || pool.width == NULL ||
+        pool.height == NULL || pool.velX == NULL || pool.velY == NULL ||
+        pool.results.hit == NULL || pool.results.time == NULL ||
+        pool.results.contactX == NULL || pool.results.contactY == NULL ||
+        pool.results.normalX == NULL || pool.results.normalY == NULL) {
+        DestroyBallPool(&pool);
+        return pool;
+    }
+
+    // every ball has the same size, fill the collision inputs once
+    for (int i = 0; i < capacity; ++i) {
+        pool.width[i] = BALL_WIDTH;
+        pool.height[i] = BALL_HEIGHT;
+    }
+
+    return pool;
+}
+
+void DestroyBallPool(BallPool *pool) {
+    free(pool->x);
+    free(pool->y);
+    free(pool->prevX);
+    free(pool->prevY);
+    free(pool->dirX);
+    free(pool->dirY);
+    free(pool->speed);
+    free(pool->hitCounter);
+    free(pool->hits);
+    free(pool->width);
+    free(pool->height);
+    free(pool->velX);
+    free(pool->velY);
+    free(pool->results.hit);
+    free(pool->results.time);
+    free(pool->results.contactX);
+    free(pool->results.contactY);
+    free(pool->results.normalX);
+    free(pool->results.normalY);
+    *pool = (BallPool){0};
+}
+
+void SpawnBalls(BallPool *pool, int count) {
+    if (pool->count + count > pool->capacity) {
+        count = pool->capacity - pool->count;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        ServeBall(pool, pool->count++);
+    }
+}
+
+int UpdateBallPool(BallPool *pool, const PongState *state, BrickGrid *bricks,
+                   float dt) {
+    int count = pool->count;
+    int hits = 0;
+
+    memcpy(pool->prevX, pool->x, count * sizeof(float));
+    memcpy(pool->prevY, pool->y, count * sizeof(float));
+
+    // velocity for this tick
+    for (int i = 0; i < count; ++i) {
+        pool->velX[i] = pool->dirX[i] * (pool->speed[i] * dt);
+        pool->velY[i] = pool->dirY[i] * (pool->speed[i] * dt);
+    }
+
+    // every ball against both paddles at once
+    const Entity *paddles[2] = {&state->leftPaddle, &state->rightPaddle};
+    float paddleX[2], paddleY[2], paddleWidth[2], paddleHeight[2];
+    for (int p = 0; p < 2; ++p) {
+        paddleX[p] = paddles[p]->rect.x;
+        paddleY[p] = paddles[p]->rect.y;
+        paddleWidth[p] = paddles[p]->rect.width;
+        paddleHeight[p] = paddles[p]->rect.height;
+    }
+
+    SweptMovers movers = {.x = pool->x,
+                          .y = pool->y,
+                          .width = pool->width,
+                          .height = pool->height,
+                          .velX = pool->velX,
+                          .velY = pool->velY,
+                          .count = count};
+    SweptTargets targets = {.x = paddleX,
+                            .y = paddleY,
+                            .width = paddleWidth,
+                            .height = paddleHeight,
+                            .count = 2};
+    SweptAABBBatch(&movers, &targets, &pool->results);
+
+    // every ball goes to its earliest impact and on with the rest of the tick, like
+    // the match ball in PongStepBricks. The first paddle sweep comes from the batch,
+    // balls bouncing more than once in a tick are few.
+    const SweptResults *results = &pool->results;
+    for (int i = 0; i < count; ++i) {
+        // most balls fly clear of the paddles and the borders, they only move
+        float y = pool->y[i] + pool->velY[i];
+        if (bricks == NULL && !results->hit[i] && !results->hit[count + i] &&
+            y > LIMIT_TOP && y + BALL_HEIGHT < LIMIT_BOTTOM) {
+            pool->x[i] += pool->velX[i];
+            pool->y[i] = y;
+            continue;
+        }
+
+        bool hitPaddle = false;
+        float remaining = 1.0f;
+        for (int impact = 0; impact < BALL_IMPACTS_MAX && remaining > 0.0f; ++impact) {
+            Rectangle rect = {pool->x[i], pool->y[i], BALL_WIDTH, BALL_HEIGHT};
+            Vector2 vel = {pool->dirX[i] * (pool->speed[i] * dt * remaining),
+                           pool->dirY[i] * (pool->speed[i] * dt * remaining)};
+            CollisionData paddleHit[2];
+            for (int p = 0; p < 2; ++p) {
+                paddleHit[p] = impact == 0 ? BatchedPaddleHit(pool, p * count + i, rect,
+                                                              *paddles[p], vel)
+                                           : SweepBallPaddle(rect, *paddles[p], vel);
+            }
+            CollisionData brick = {.time = 1.0f};
+            int brickHit = -1;
+            if (bricks != NULL) {
+                brickHit = FindBrickHit(bricks, rect, vel, &brick);
+            }
+            CollisionData border = SweepBallBorders(rect, vel);
+
+            float leftTime = ImpactTime(paddleHit[0]);
+            float rightTime = ImpactTime(paddleHit[1]);
+            float brickTime = ImpactTime(brick);
+            float time = fminf(fminf(leftTime, rightTime),
+                               fminf(brickTime, ImpactTime(border)));
+            if (time > 1.0f) {
+                pool->x[i] += vel.x;
+                pool->y[i] += vel.y;
+                break;
+            }
+
+            // paddles win a tie, the left one first, then bricks
+            if (leftTime == time || rightTime == time) {
+                int p = leftTime == time ? 0 : 1;
+                BouncePaddle(pool, i, *paddles[p], paddleHit[p]);
+                hitPaddle = true;
+            } else if (brickTime == time) {
+                BounceWall(pool, i, brick);
+                RemoveBrick(bricks, brickHit);
+            } else {
+                BounceWall(pool, i, border);
+            }
+            remaining *= 1.0f - time;
+        }
+
+        if (hitPaddle) {
+            pool->hits[hits++] = i;
+        }
+    }
+
+    // serve balls that left the arena again
+    for (int i = 0; i < count; ++i) {
+        if (pool->x[i] + BALL_WIDTH < 0.0f || pool->x[i] > SCREEN_WIDTH) {
+            ServeBall(pool, i);
+        }
+    }
+
+    return hits;
+}
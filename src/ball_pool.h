@@ -0,0 +1,44 @@
+#ifndef BALL_POOL_H
+#define BALL_POOL_H
+
+#include "brick_grid.h"
+#include "collision_batch.h"
+#include "pong_sim.h"
+
+// Max number of balls a pool is created with by the game
+#define BALL_POOL_CAPACITY 16384
+
+// Pool balls never score, nothing serves them again while the paddles return them, so
+// their speed stops growing here. It is reached after 256 paddle hits.
+#define BALL_POOL_SPEED_MAX (BALL_INITIAL_SPEED + BALL_SPEED_INCREMENT * 16)
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+// Extra balls stored as structure-of-arrays, they bounce on paddles and borders like
+// the match ball but never score, a ball leaving the arena is served again. A pool
+// that can't be allocated is created with no capacity, so it never spawns a ball.
+typedef struct BallPool {
+    float *x, *y;         // position
+    float *prevX, *prevY; // position on the previous tick, for interpolation
+    float *dirX, *dirY;   // normilized direction
+    float *speed;         // velocity multiplier
+    int *hitCounter;      // paddle hits since the ball was served
+    int *hits;            // balls that hit a paddle on the last update
+    int count, capacity;
+    unsigned int rngState;
+
+    // scratch used by the batched paddle collision, one entry per ball
+    float *width, *height, *velX, *velY;
+    SweptResults results; // one entry per ball and paddle
+} BallPool;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+BallPool CreateBallPool(int capacity, unsigned int seed);
+void DestroyBallPool(BallPool *pool);
+void SpawnBalls(BallPool *pool, int count);
+int UpdateBallPool(BallPool *pool, const PongState *state, BrickGrid *bricks, float dt);
+
+#endif // BALL_POOL_H
@@ -0,0 +1,319 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pong_sim.h"
+#include "snake_sim.h"
+#include "tick.h"
+
+// Inputs generated per benchmark, operations cycle through them
+#define BENCH_INPUTS 4096
+
+#define DEFAULT_REPS   200
+#define DEFAULT_WARMUP 20
+#define DEFAULT_OPS    4096
+
+#ifndef BENCH_CFLAGS
+#define BENCH_CFLAGS ""
+#endif
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+// Seeded inputs shared by every benchmark, generated once before timing
+typedef struct BenchInputs {
+    Rectangle rects[BENCH_INPUTS];
+    Rectangle targets[BENCH_INPUTS];
+    Vector2 vels[BENCH_INPUTS];
+    Entity balls[BENCH_INPUTS];
+    Direction dirs[BENCH_INPUTS];
+} BenchInputs;
+
+typedef struct Benchmark {
+    const char *name;
+    float (*run)(const BenchInputs *inputs, int ops); // returns a checksum
+} Benchmark;
+
+typedef struct BenchResult {
+    double p50, p99, min, mean; // ns per operation
+} BenchResult;
+
+// -------------------------------------------------------------------------------------
+// Globals
+// -------------------------------------------------------------------------------------
+// Checksums land here so the compiler can't drop the benchmarked calls
+static volatile float benchSink;
+
+// Created before timing so SnakeStep runs only reset it, its body never reallocated
+static SnakeState benchSnake;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+float BenchRandom(unsigned int *state);
+void GenerateInputs(BenchInputs *inputs, unsigned int seed);
+BenchResult RunBenchmark(const Benchmark *bench, const BenchInputs *inputs, int ops,
+                         int warmup, int reps, double *samples);
+int CompareDoubles(const void *a, const void *b);
+
+// Benchmarked kernels
+float BenchSweptAABB(const BenchInputs *inputs, int ops);
+float BenchAABBCheck(const BenchInputs *inputs, int ops);
+float BenchRayIntersectLine(const BenchInputs *inputs, int ops);
+float BenchBouncePoints(const BenchInputs *inputs, int ops);
+float BenchPredictLanding(const BenchInputs *inputs, int ops);
+float BenchSnakeStep(const BenchInputs *inputs, int ops);
+
+static const Benchmark benchmarks[] = {
+    {"SweptAABB", BenchSweptAABB},
+    {"AABBCheck", BenchAABBCheck},
+    {"RayIntersectLine", BenchRayIntersectLine},
+    {"CalculateBouncePoints", BenchBouncePoints},
+    {"PredictBallLanding", BenchPredictLanding},
+    {"SnakeStep", BenchSnakeStep},
+};
+
+// -------------------------------------------------------------------------------------
+// Entrypoint
+// -------------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+    unsigned int seed = 1;
+    int reps = DEFAULT_REPS;
+    int warmup = DEFAULT_WARMUP;
+    int ops = DEFAULT_OPS;
+    const char *filter = NULL;
+    bool json = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            reps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmup = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+            ops = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--seed S] [--reps N] [--warmup N] [--ops N]\n"
+                    "          [--filter NAME] [--json]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (reps < 1 || ops < 1 || warmup < 0) {
+        fprintf(stderr, "reps and ops must be positive\n");
+        return 1;
+    }
+
+    BenchInputs *inputs = malloc(sizeof(BenchInputs));
+    double *samples = malloc(reps * sizeof(double));
+    benchSnake = CreateSnakeState(1);
+    if (inputs == NULL || samples == NULL || benchSnake.body == NULL) {
+        fprintf(stderr, "can't allocate the benchmark inputs\n");
+        DestroySnakeState(&benchSnake);
+        free(samples);
+        free(inputs);
+        return 1;
+    }
+    GenerateInputs(inputs, seed);
+
+    if (json) {
+        printf("{\n  \"seed\": %u,\n  \"reps\": %d,\n", seed, reps);
+        printf("  \"warmup\": %d,\n  \"ops\": %d,\n", warmup, ops);
+        printf("  \"compiler\": \"%s\",\n  \"cflags\": \"%s\",\n", __VERSION__,
+               BENCH_CFLAGS);
+        printf("  \"benchmarks\": [");
+    } else {
+        printf("%-24s %12s %12s %12s %12s\n", "benchmark", "p50 ns/op", "p99 ns/op",
+               "min ns/op", "mean ns/op");
+    }
+
+    int count = 0;
+    for (int i = 0; i < (int)(sizeof(benchmarks) / sizeof(Benchmark)); ++i) {
+        const Benchmark *bench = &benchmarks[i];
+        if (filter != NULL && strstr(bench->name, filter) == NULL) {
+            continue;
+        }
+
+        BenchResult result = RunBenchmark(bench, inputs, ops, warmup, reps, samples);
+        if (json) {
+            printf("%s\n    {\"name\": \"%s\", \"p50_ns\": %.3f, \"p99_ns\": %.3f, "
+                   "\"min_ns\": %.3f, \"mean_ns\": %.3f}",
+                   count > 0 ? "," : "", bench->name, result.p50, result.p99,
+                   result.min, result.mean);
+        } else {
+            printf("%-24s %12.2f %12.2f %12.2f %12.2f\n", bench->name, result.p50,
+                   result.p99, result.min, result.mean);
+        }
+        ++count;
+    }
+
+    if (json) {
+        printf("\n  ]\n}\n");
+    }
+
+    DestroySnakeState(&benchSnake);
+    free(samples);
+    free(inputs);
+
+    return 0;
+}
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+float BenchRandom(unsigned int *state) {
+    // xorshift32, same generator as the simulations, mapped to [0.0,1.0)
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    return (x >> 8) / 16777216.0f;
+}
+
+void GenerateInputs(BenchInputs *inputs, unsigned int seed) {
+    unsigned int rng = seed != 0 ? seed : 0x9e3779b9u;
+
+    for (int i = 0; i < BENCH_INPUTS; ++i) {
+        // a ball somewhere on the field moving at one of the rally speeds
+        float angle = BenchRandom(&rng) * 2.0f * PI;
+        float speed = BALL_INITIAL_SPEED + BenchRandom(&rng) * 4 * BALL_SPEED_INCREMENT;
+        Rectangle rect = {LIMIT_LEFT + BenchRandom(&rng) * (LIMIT_RIGHT - LIMIT_LEFT),
+                          LIMIT_TOP + BenchRandom(&rng) * (LIMIT_BOTTOM - LIMIT_TOP),
+                          BALL_WIDTH, BALL_HEIGHT};
+        Vector2 dir = {cosf(angle), sinf(angle)};
+
+        // paddles close enough that about half of the sweeps overlap them
+        inputs->rects[i] = rect;
+        inputs->vels[i] = (Vector2){dir.x * speed * PONG_TICK_DT * 4,
+                                    dir.y * speed * PONG_TICK_DT * 4};
+        inputs->targets[i] =
+            (Rectangle){rect.x + (BenchRandom(&rng) - 0.5f) * 4 * PADDLE_WIDTH,
+                        rect.y + (BenchRandom(&rng) - 0.5f) * 2 * PADDLE_HEIGHT,
+                        PADDLE_WIDTH, PADDLE_HEIGHT};
+
+        // serves like PongResetBall plus steeper returns off the paddle edges
+        float dirY = (BenchRandom(&rng) * 2.0f - 1.0f) * 3.0f;
+        float dirX = BenchRandom(&rng) < 0.5f ? -1.0f : 1.0f;
+        float length = sqrtf(dirX * dirX + dirY * dirY);
+        inputs->balls[i] = (Entity){.rect = rect,
+                                    .dir = (Vector2){dirX / length, dirY / length},
+                                    .speed = speed};
+
+        inputs->dirs[i] = DIR_UP + (int)(BenchRandom(&rng) * 4);
+    }
+}
+
+BenchResult RunBenchmark(const Benchmark *bench, const BenchInputs *inputs, int ops,
+                         int warmup, int reps, double *samples) {
+    BenchResult result = {0};
+
+    for (int i = 0; i < warmup; ++i) {
+        benchSink = bench->run(inputs, ops);
+    }
+
+    for (int i = 0; i < reps; ++i) {
+        double start = GetSeconds();
+        benchSink = bench->run(inputs, ops);
+        samples[i] = (GetSeconds() - start) * 1e9 / ops;
+        result.mean += samples[i] / reps;
+    }
+
+    // nearest rank percentiles
+    qsort(samples, reps, sizeof(double), CompareDoubles);
+    result.min = samples[0];
+    result.p50 = samples[(reps - 1) * 50 / 100];
+    result.p99 = samples[(reps - 1) * 99 / 100];
+
+    return result;
+}
+
+int CompareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+float BenchSweptAABB(const BenchInputs *inputs, int ops) {
+    float sum = 0.0f;
+    for (int i = 0; i < ops; ++i) {
+        int k = i % BENCH_INPUTS;
+        CollisionData data = SweptAABB(inputs->rects[k], inputs->vels[k],
+                                       inputs->targets[k]);
+        sum += data.time;
+    }
+    return sum;
+}
+
+float BenchAABBCheck(const BenchInputs *inputs, int ops) {
+    float sum = 0.0f;
+    for (int i = 0; i < ops; ++i) {
+        int k = i % BENCH_INPUTS;
+        Rectangle swept = SweptRectangle(inputs->rects[k], inputs->vels[k]);
+        sum += AABBCheck(swept, inputs->targets[k]);
+    }
+    return sum;
+}
+
+float BenchRayIntersectLine(const BenchInputs *inputs, int ops) {
+    Vector2 lineStarts[4], lineEnds[4];
+    GetBounceLines(lineStarts, lineEnds);
+
+    float sum = 0.0f;
+    for (int i = 0; i < ops; ++i) {
+        int k = i % BENCH_INPUTS;
+        Vector2 origin = {inputs->balls[k].rect.x, inputs->balls[k].rect.y};
+        Vector2 point;
+        float time;
+        if (RayIntersectLine(origin, inputs->balls[k].dir, lineStarts[i & 3],
+                             lineEnds[i & 3], &point, &time)) {
+            sum += time;
+        }
+    }
+    return sum;
+}
+
+float BenchBouncePoints(const BenchInputs *inputs, int ops) {
+    Vector2 bouncePoints[BOUNCE_POINTS_MAX];
+
+    float sum = 0.0f;
+    for (int i = 0; i < ops; ++i) {
+        Entity ball = inputs->balls[i % BENCH_INPUTS];
+        sum += bouncePoints[CalculateBouncePoints(ball, bouncePoints)].y;
+    }
+    return sum;
+}
+
+float BenchPredictLanding(const BenchInputs *inputs, int ops) {
+    float sum = 0.0f;
+    for (int i = 0; i < ops; ++i) {
+        sum += PredictBallLanding(inputs->balls[i % BENCH_INPUTS]);
+    }
+    return sum;
+}
+
+float BenchSnakeStep(const BenchInputs *inputs, int ops) {
+    // every run starts from the same snake, a dead one starts over like in the game
+    SnakeState *state = &benchSnake;
+    SnakeInit(state, 1);
+
+    float sum = 0.0f;
+    for (int i = 0; i < ops; ++i) {
+        state->dir = inputs->dirs[i % BENCH_INPUTS];
+        SnakeStep(state);
+        sum += state->events;
+        if (state->events & (SNAKE_EVENT_DEAD | SNAKE_EVENT_WIN)) {
+            SnakeInit(state, i + 1);
+        }
+    }
+    sum += SnakeHead(state);
+
+    return sum;
+}
@@ -0,0 +1,188 @@
+#include "brick_grid.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static int CellColumn(const BrickGrid *grid, float x) {
+    int column = (int)floorf(x / grid->cellSize);
+    return column < 0 ? 0 : (column >= grid->columns ? grid->columns - 1 : column);
+}
+
+static int CellRow(const BrickGrid *grid, float y) {
+    int row = (int)floorf(y / grid->cellSize);
+    return row < 0 ? 0 : (row >= grid->rows ? grid->rows - 1 : row);
+}
+
+BrickGrid CreateBrickGrid(Rectangle area, float brickWidth, float brickHeight,
+                          float gap, float cellSize) {
+    BrickGrid grid = {0};
+    int brickColumns = (int)((area.width + gap) / (brickWidth + gap));
+    int brickRows = (int)((area.height + gap) / (brickHeight + gap));
+
+    grid.brickCount = brickColumns * brickRows;
+    grid.bricks = malloc(grid.brickCount * sizeof(Rectangle));
+    grid.alive = malloc(grid.brickCount * sizeof(bool));
+    grid.brickStamp = calloc(grid.brickCount, sizeof(unsigned int));
+    if (grid.bricks == NULL || grid.alive == NULL || grid.brickStamp == NULL) {
+        DestroyBrickGrid(&grid);
+        return grid;
+    }
+
+    for (int y = 0; y < brickRows; ++y) {
+        for (int x = 0; x < brickColumns; ++x) {
+            grid.bricks[y * brickColumns + x] =
+                (Rectangle){area.x + x * (brickWidth + gap),
+                            area.y + y * (brickHeight + gap), brickWidth, brickHeight};
+        }
+    }
+
+    // the grid covers the whole screen so every ball maps to a cell
+    grid.cellSize = cellSize;
+    grid.columns = (int)ceilf(SCREEN_WIDTH / cellSize);
+    grid.rows = (int)ceilf(SCREEN_HEIGHT / cellSize);
+    grid.cellStart = calloc(grid.columns * grid.rows + 1, sizeof(int));
+    grid.cellCount = calloc(grid.columns * grid.rows, sizeof(int));
+    if (grid.cellStart == NULL || grid.cellCount == NULL) {
+        DestroyBrickGrid(&grid);
+        return grid;
+    }
+
+    // count how many cells each brick overlaps to size the entries
+    for (int i = 0; i < grid.brickCount; ++i) {
+        Rectangle brick = grid.bricks[i];
+        for (int row = CellRow(&grid, brick.y);
+             row <= CellRow(&grid, brick.y + brick.height); ++row) {
+            for (int column = CellColumn(&grid, brick.x);
+                 column <= CellColumn(&grid, brick.x + brick.width); ++column) {
+                ++grid.cellStart[row * grid.columns + column + 1];
+            }
+        }
+    }
+    for (int c = 0; c < grid.columns * grid.rows; ++c) {
+        grid.cellStart[c + 1] += grid.cellStart[c];
+    }
+    grid.cellBricks = malloc(grid.cellStart[grid.columns * grid.rows] * sizeof(int));
+    if (grid.cellBricks == NULL) {
+        DestroyBrickGrid(&grid);
+        return grid;
+    }
+
+    ResetBrickGrid(&grid);
+
+    return grid;
+}
+
+void DestroyBrickGrid(BrickGrid *grid) {
+    free(grid->bricks);
+    free(grid->alive);
+    free(grid->brickStamp);
+    free(grid->cellStart);
+    free(grid->cellCount);
+    free(grid->cellBricks);
+    *grid = (BrickGrid){0};
+}
+
+void ResetBrickGrid(BrickGrid *grid) {
+    for (int c = 0; c < grid->columns * grid->rows; ++c) {
+        grid->cellCount[c] = 0;
+    }
+
+    for (int i = 0; i < grid->brickCount; ++i) {
+        Rectangle brick = grid->bricks[i];
+        grid->alive[i] = true;
+
+        for (int row = CellRow(grid, brick.y);
+             row <= CellRow(grid, brick.y + brick.height); ++row) {
+            for (int column = CellColumn(grid, brick.x);
+                 column <= CellColumn(grid, brick.x + brick.width); ++column) {
+                int cell = row * grid->columns + column;
+                grid->cellBricks[grid->cellStart[cell] + grid->cellCount[cell]++] = i;
+            }
+        }
+    }
+
+    grid->aliveCount = grid->brickCount;
+}
+
+void RemoveBrick(BrickGrid *grid, int brick) {
+    if (!grid->alive[brick]) {
+        return;
+    }
+
+    Rectangle rect = grid->bricks[brick];
+    grid->alive[brick] = false;
+    --grid->aliveCount;
+
+    // swap the brick with the last alive entry of every cell it overlaps
+    for (int row = CellRow(grid, rect.y); row <= CellRow(grid, rect.y + rect.height);
+         ++row) {
+        for (int column = CellColumn(grid, rect.x);
+             column <= CellColumn(grid, rect.x + rect.width); ++column) {
+            int cell = row * grid->columns + column;
+            int *entries = &grid->cellBricks[grid->cellStart[cell]];
+            int last = --grid->cellCount[cell];
+
+            for (int i = 0; i <= last; ++i) {
+                if (entries[i] == brick) {
+                    entries[i] = entries[last];
+                    entries[last] = brick;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+int FindBrickHit(BrickGrid *grid, Rectangle rect, Vector2 vel,
+                 CollisionData *collData) {
+    Rectangle sweptRect = SweptRectangle(rect, vel);
+    int hitBrick = -1;
+
+    collData->hit = false;
+    collData->time = 1.0f;
+    if (grid->brickCount == 0) {
+        return hitBrick;
+    }
+
+    // stamp visited bricks, a brick spanning several cells is only tested once
+    if (++grid->queryStamp == 0) {
+        for (int i = 0; i < grid->brickCount; ++i) {
+            grid->brickStamp[i] = 0;
+        }
+        grid->queryStamp = 1;
+    }
+
+    int lastRow = CellRow(grid, sweptRect.y + sweptRect.height);
+    int lastColumn = CellColumn(grid, sweptRect.x + sweptRect.width);
+    for (int row = CellRow(grid, sweptRect.y); row <= lastRow; ++row) {
+        for (int column = CellColumn(grid, sweptRect.x); column <= lastColumn;
+             ++column) {
+            int cell = row * grid->columns + column;
+            const int *entries = &grid->cellBricks[grid->cellStart[cell]];
+
+            for (int i = 0; i < grid->cellCount[cell]; ++i) {
+                int brick = entries[i];
+                if (grid->brickStamp[brick] == grid->queryStamp) {
+                    continue;
+                }
+                grid->brickStamp[brick] = grid->queryStamp;
+
+                if (!AABBCheck(sweptRect, grid->bricks[brick])) {
+                    continue;
+                }
+
+                // keep the earliest hit along the movement
+                CollisionData data = SweptAABB(rect, vel, grid->bricks[brick]);
+                if (data.hit && (hitBrick < 0 || data.time < collData->time)) {
+                    *collData = data;
+                    hitBrick = brick;
+                }
+            }
+        }
+    }
+
+    return hitBrick;
+}
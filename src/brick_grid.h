@@ -0,0 +1,48 @@
+#ifndef BRICK_GRID_H
+#define BRICK_GRID_H
+
+#include <raylib.h>
+#include <stdbool.h>
+
+#include "pong_sim.h"
+
+// Brick arena layout
+#define ARENA_AREA         (Rectangle){220, 45, 360, 510}
+#define ARENA_BRICK_WIDTH  10
+#define ARENA_BRICK_HEIGHT 10
+#define ARENA_BRICK_GAP    2
+#define ARENA_CELL_SIZE    32
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+// Destructible bricks indexed by a uniform grid over the screen. Each cell keeps the
+// bricks overlapping it in a slice of cellBricks, alive ones first, so a query only
+// looks at the cells under the swept ball and removing a brick only touches its cells.
+// A grid that can't be allocated is created empty, without bricks or cells.
+typedef struct BrickGrid {
+    Rectangle *bricks;
+    bool *alive;
+    int brickCount, aliveCount;
+
+    float cellSize;
+    int columns, rows;
+    int *cellStart; // first entry of every cell in cellBricks, columns * rows + 1
+    int *cellCount; // alive bricks of every cell
+    int *cellBricks;
+
+    unsigned int *brickStamp; // last query that visited a brick, bricks can span cells
+    unsigned int queryStamp;
+} BrickGrid;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+BrickGrid CreateBrickGrid(Rectangle area, float brickWidth, float brickHeight,
+                          float gap, float cellSize);
+void DestroyBrickGrid(BrickGrid *grid);
+void ResetBrickGrid(BrickGrid *grid);
+void RemoveBrick(BrickGrid *grid, int brick);
+int FindBrickHit(BrickGrid *grid, Rectangle rect, Vector2 vel, CollisionData *collData);
+
+#endif // BRICK_GRID_H
@@ -0,0 +1,309 @@
+#include "collision_batch.h"
+
+#include <math.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86
+#include <immintrin.h>
+#endif
+
+// The vector paths mirror SweptAABB operation by operation so results are bit for bit
+// identical: the same additions, subtractions and IEEE divisions in the same order,
+// fmaxf(a, b) as max(b, a) and fminf(a, b) as min(b, a), which pick the same operand
+// on ties, and no fused multiply-add.
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static void SweptLane(const SweptMovers *movers, Rectangle target, int mover, int out,
+                      SweptResults *results) {
+    Rectangle rect = {movers->x[mover], movers->y[mover], movers->width[mover],
+                      movers->height[mover]};
+    Vector2 vel = {movers->velX[mover], movers->velY[mover]};
+    CollisionData data = SweptAABB(rect, vel, target);
+
+    results->hit[out] = data.hit;
+    results->time[out] = data.time;
+    results->contactX[out] = data.contactPoint.x;
+    results->contactY[out] = data.contactPoint.y;
+    results->normalX[out] = data.contactNormal.x;
+    results->normalY[out] = data.contactNormal.y;
+}
+
+static int SweptScalar(const SweptMovers *movers, Rectangle target, int first, int base,
+                       SweptResults *results) {
+    for (int i = first; i < movers->count; ++i) {
+        SweptLane(movers, target, i, base + i, results);
+    }
+    return movers->count;
+}
+
+#if defined(SIMD_X86)
+static inline __m128 SelectSSE(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static int SweptSSE(const SweptMovers *movers, Rectangle target, int first, int base,
+                    SweptResults *results) {
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    const __m128 minusOne = _mm_set1_ps(-1.0f);
+    const __m128 inf = _mm_set1_ps(INFINITY), minusInf = _mm_set1_ps(-INFINITY);
+    const __m128 tx = _mm_set1_ps(target.x), ty = _mm_set1_ps(target.y);
+    const __m128 tw = _mm_set1_ps(target.width), th = _mm_set1_ps(target.height);
+    int i = first;
+
+    for (; i + 4 <= movers->count; i += 4) {
+        __m128 x = _mm_loadu_ps(movers->x + i), y = _mm_loadu_ps(movers->y + i);
+        __m128 w = _mm_loadu_ps(movers->width + i);
+        __m128 h = _mm_loadu_ps(movers->height + i);
+        __m128 vx = _mm_loadu_ps(movers->velX + i), vy = _mm_loadu_ps(movers->velY + i);
+
+        // distances to the near and far sides of the target on each axis
+        __m128 xPos = _mm_cmpgt_ps(vx, zero), yPos = _mm_cmpgt_ps(vy, zero);
+        __m128 xA = _mm_sub_ps(tx, _mm_add_ps(x, w));
+        __m128 xB = _mm_sub_ps(_mm_add_ps(tx, tw), x);
+        __m128 yA = _mm_sub_ps(ty, _mm_add_ps(y, h));
+        __m128 yB = _mm_sub_ps(_mm_add_ps(ty, th), y);
+        __m128 invEntryX = SelectSSE(xPos, xA, xB), invExitX = SelectSSE(xPos, xB, xA);
+        __m128 invEntryY = SelectSSE(yPos, yA, yB), invExitY = SelectSSE(yPos, yB, yA);
+
+        // entry and exit times
+        __m128 xMoving = _mm_cmpneq_ps(vx, zero), yMoving = _mm_cmpneq_ps(vy, zero);
+        __m128 entryX = SelectSSE(xMoving, _mm_div_ps(invEntryX, vx), minusInf);
+        __m128 exitX = SelectSSE(xMoving, _mm_div_ps(invExitX, vx), inf);
+        __m128 entryY = SelectSSE(yMoving, _mm_div_ps(invEntryY, vy), minusInf);
+        __m128 exitY = SelectSSE(yMoving, _mm_div_ps(invExitY, vy), inf);
+        __m128 entryTime = _mm_max_ps(entryY, entryX);
+        __m128 exitTime = _mm_min_ps(exitY, exitX);
+
+        __m128 miss = _mm_cmpgt_ps(entryTime, exitTime);
+        miss = _mm_or_ps(miss, _mm_and_ps(_mm_cmplt_ps(entryX, zero),
+                                          _mm_cmplt_ps(entryY, zero)));
+        miss = _mm_or_ps(miss, _mm_cmpgt_ps(entryX, one));
+        miss = _mm_or_ps(miss, _mm_cmpgt_ps(entryY, one));
+        __m128 hit = _mm_cmpeq_ps(miss, zero);
+
+        // normal on the axis entered last, contact point along the velocity
+        __m128 xAxis = _mm_and_ps(hit, _mm_cmpgt_ps(entryX, entryY));
+        __m128 yAxis = _mm_andnot_ps(xAxis, hit);
+        __m128 normalX = SelectSSE(_mm_cmplt_ps(invEntryX, zero), one, minusOne);
+        __m128 normalY = SelectSSE(_mm_cmplt_ps(invEntryY, zero), one, minusOne);
+        __m128 contactX = _mm_add_ps(x, _mm_mul_ps(vx, entryTime));
+        __m128 contactY = _mm_add_ps(y, _mm_mul_ps(vy, entryTime));
+
+        int out = base + i;
+        _mm_storeu_si128((__m128i *)(results->hit + out),
+                         _mm_and_si128(_mm_castps_si128(hit), _mm_set1_epi32(1)));
+        _mm_storeu_ps(results->time + out, SelectSSE(hit, entryTime, one));
+        _mm_storeu_ps(results->contactX + out, _mm_and_ps(hit, contactX));
+        _mm_storeu_ps(results->contactY + out, _mm_and_ps(hit, contactY));
+        _mm_storeu_ps(results->normalX + out, _mm_and_ps(xAxis, normalX));
+        _mm_storeu_ps(results->normalY + out, _mm_and_ps(yAxis, normalY));
+    }
+
+    return i;
+}
+
+__attribute__((target("avx2"))) static int
+SweptAVX2(const SweptMovers *movers, Rectangle target, int first, int base,
+          SweptResults *results) {
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+    const __m256 minusOne = _mm256_set1_ps(-1.0f);
+    const __m256 inf = _mm256_set1_ps(INFINITY), minusInf = _mm256_set1_ps(-INFINITY);
+    const __m256 tx = _mm256_set1_ps(target.x), ty = _mm256_set1_ps(target.y);
+    const __m256 tw = _mm256_set1_ps(target.width), th = _mm256_set1_ps(target.height);
+    int i = first;
+
+    for (; i + 8 <= movers->count; i += 8) {
+        __m256 x = _mm256_loadu_ps(movers->x + i), y = _mm256_loadu_ps(movers->y + i);
+        __m256 w = _mm256_loadu_ps(movers->width + i);
+        __m256 h = _mm256_loadu_ps(movers->height + i);
+        __m256 vx = _mm256_loadu_ps(movers->velX + i);
+        __m256 vy = _mm256_loadu_ps(movers->velY + i);
+
+        // distances to the near and far sides of the target on each axis
+        __m256 xPos = _mm256_cmp_ps(vx, zero, _CMP_GT_OQ);
+        __m256 yPos = _mm256_cmp_ps(vy, zero, _CMP_GT_OQ);
+        __m256 xA = _mm256_sub_ps(tx, _mm256_add_ps(x, w));
+        __m256 xB = _mm256_sub_ps(_mm256_add_ps(tx, tw), x);
+        __m256 yA = _mm256_sub_ps(ty, _mm256_add_ps(y, h));
+        __m256 yB = _mm256_sub_ps(_mm256_add_ps(ty, th), y);
+        __m256 invEntryX = _mm256_blendv_ps(xB, xA, xPos);
+        __m256 invExitX = _mm256_blendv_ps(xA, xB, xPos);
+        __m256 invEntryY = _mm256_blendv_ps(yB, yA, yPos);
+        __m256 invExitY = _mm256_blendv_ps(yA, yB, yPos);
+
+        // entry and exit times
+        __m256 xMoving = _mm256_cmp_ps(vx, zero, _CMP_NEQ_UQ);
+        __m256 yMoving = _mm256_cmp_ps(vy, zero, _CMP_NEQ_UQ);
+        __m256 entryX =
+            _mm256_blendv_ps(minusInf, _mm256_div_ps(invEntryX, vx), xMoving);
+        __m256 exitX = _mm256_blendv_ps(inf, _mm256_div_ps(invExitX, vx), xMoving);
+        __m256 entryY =
+            _mm256_blendv_ps(minusInf, _mm256_div_ps(invEntryY, vy), yMoving);
+        __m256 exitY = _mm256_blendv_ps(inf, _mm256_div_ps(invExitY, vy), yMoving);
+        __m256 entryTime = _mm256_max_ps(entryY, entryX);
+        __m256 exitTime = _mm256_min_ps(exitY, exitX);
+
+        __m256 miss = _mm256_cmp_ps(entryTime, exitTime, _CMP_GT_OQ);
+        __m256 behind = _mm256_and_ps(_mm256_cmp_ps(entryX, zero, _CMP_LT_OQ),
+                                      _mm256_cmp_ps(entryY, zero, _CMP_LT_OQ));
+        miss = _mm256_or_ps(miss, behind);
+        miss = _mm256_or_ps(miss, _mm256_cmp_ps(entryX, one, _CMP_GT_OQ));
+        miss = _mm256_or_ps(miss, _mm256_cmp_ps(entryY, one, _CMP_GT_OQ));
+        __m256 hit = _mm256_cmp_ps(miss, zero, _CMP_EQ_OQ);
+
+        // normal on the axis entered last, contact point along the velocity
+        __m256 xAxis = _mm256_and_ps(hit, _mm256_cmp_ps(entryX, entryY, _CMP_GT_OQ));
+        __m256 yAxis = _mm256_andnot_ps(xAxis, hit);
+        __m256 normalX =
+            _mm256_blendv_ps(minusOne, one, _mm256_cmp_ps(invEntryX, zero, _CMP_LT_OQ));
+        __m256 normalY =
+            _mm256_blendv_ps(minusOne, one, _mm256_cmp_ps(invEntryY, zero, _CMP_LT_OQ));
+        __m256 contactX = _mm256_add_ps(x, _mm256_mul_ps(vx, entryTime));
+        __m256 contactY = _mm256_add_ps(y, _mm256_mul_ps(vy, entryTime));
+
+        int out = base + i;
+        _mm256_storeu_si256(
+            (__m256i *)(results->hit + out),
+            _mm256_and_si256(_mm256_castps_si256(hit), _mm256_set1_epi32(1)));
+        _mm256_storeu_ps(results->time + out, _mm256_blendv_ps(one, entryTime, hit));
+        _mm256_storeu_ps(results->contactX + out, _mm256_and_ps(hit, contactX));
+        _mm256_storeu_ps(results->contactY + out, _mm256_and_ps(hit, contactY));
+        _mm256_storeu_ps(results->normalX + out, _mm256_and_ps(xAxis, normalX));
+        _mm256_storeu_ps(results->normalY + out, _mm256_and_ps(yAxis, normalY));
+    }
+
+    return i;
+}
+
+__attribute__((target("avx512f"))) static int
+SweptAVX512(const SweptMovers *movers, Rectangle target, int first, int base,
+            SweptResults *results) {
+    const __m512 zero = _mm512_setzero_ps(), one = _mm512_set1_ps(1.0f);
+    const __m512 minusOne = _mm512_set1_ps(-1.0f);
+    const __m512 inf = _mm512_set1_ps(INFINITY), minusInf = _mm512_set1_ps(-INFINITY);
+    const __m512 tx = _mm512_set1_ps(target.x), ty = _mm512_set1_ps(target.y);
+    const __m512 tw = _mm512_set1_ps(target.width), th = _mm512_set1_ps(target.height);
+    int i = first;
+
+    for (; i + 16 <= movers->count; i += 16) {
+        __m512 x = _mm512_loadu_ps(movers->x + i), y = _mm512_loadu_ps(movers->y + i);
+        __m512 w = _mm512_loadu_ps(movers->width + i);
+        __m512 h = _mm512_loadu_ps(movers->height + i);
+        __m512 vx = _mm512_loadu_ps(movers->velX + i);
+        __m512 vy = _mm512_loadu_ps(movers->velY + i);
+
+        // distances to the near and far sides of the target on each axis
+        __mmask16 xPos = _mm512_cmp_ps_mask(vx, zero, _CMP_GT_OQ);
+        __mmask16 yPos = _mm512_cmp_ps_mask(vy, zero, _CMP_GT_OQ);
+        __m512 xA = _mm512_sub_ps(tx, _mm512_add_ps(x, w));
+        __m512 xB = _mm512_sub_ps(_mm512_add_ps(tx, tw), x);
+        __m512 yA = _mm512_sub_ps(ty, _mm512_add_ps(y, h));
+        __m512 yB = _mm512_sub_ps(_mm512_add_ps(ty, th), y);
+        __m512 invEntryX = _mm512_mask_blend_ps(xPos, xB, xA);
+        __m512 invExitX = _mm512_mask_blend_ps(xPos, xA, xB);
+        __m512 invEntryY = _mm512_mask_blend_ps(yPos, yB, yA);
+        __m512 invExitY = _mm512_mask_blend_ps(yPos, yA, yB);
+
+        // entry and exit times
+        __mmask16 xMoving = _mm512_cmp_ps_mask(vx, zero, _CMP_NEQ_UQ);
+        __mmask16 yMoving = _mm512_cmp_ps_mask(vy, zero, _CMP_NEQ_UQ);
+        __m512 entryX = _mm512_mask_div_ps(minusInf, xMoving, invEntryX, vx);
+        __m512 exitX = _mm512_mask_div_ps(inf, xMoving, invExitX, vx);
+        __m512 entryY = _mm512_mask_div_ps(minusInf, yMoving, invEntryY, vy);
+        __m512 exitY = _mm512_mask_div_ps(inf, yMoving, invExitY, vy);
+        __m512 entryTime = _mm512_max_ps(entryY, entryX);
+        __m512 exitTime = _mm512_min_ps(exitY, exitX);
+
+        __mmask16 miss = _mm512_cmp_ps_mask(entryTime, exitTime, _CMP_GT_OQ);
+        miss |= _mm512_cmp_ps_mask(entryX, zero, _CMP_LT_OQ) &
+                _mm512_cmp_ps_mask(entryY, zero, _CMP_LT_OQ);
+        miss |= _mm512_cmp_ps_mask(entryX, one, _CMP_GT_OQ);
+        miss |= _mm512_cmp_ps_mask(entryY, one, _CMP_GT_OQ);
+        __mmask16 hit = (__mmask16)~miss;
+
+        // normal on the axis entered last, contact point along the velocity
+        __mmask16 xAxis = hit & _mm512_cmp_ps_mask(entryX, entryY, _CMP_GT_OQ);
+        __mmask16 yAxis = hit & (__mmask16)~xAxis;
+        __m512 normalX = _mm512_mask_blend_ps(
+            _mm512_cmp_ps_mask(invEntryX, zero, _CMP_LT_OQ), minusOne, one);
+        __m512 normalY = _mm512_mask_blend_ps(
+            _mm512_cmp_ps_mask(invEntryY, zero, _CMP_LT_OQ), minusOne, one);
+        __m512 contactX = _mm512_add_ps(x, _mm512_mul_ps(vx, entryTime));
+        __m512 contactY = _mm512_add_ps(y, _mm512_mul_ps(vy, entryTime));
+
+        int out = base + i;
+        _mm512_storeu_si512(results->hit + out,
+                            _mm512_maskz_mov_epi32(hit, _mm512_set1_epi32(1)));
+        _mm512_storeu_ps(results->time + out,
+                         _mm512_mask_blend_ps(hit, one, entryTime));
+        _mm512_storeu_ps(results->contactX + out, _mm512_maskz_mov_ps(hit, contactX));
+        _mm512_storeu_ps(results->contactY + out, _mm512_maskz_mov_ps(hit, contactY));
+        _mm512_storeu_ps(results->normalX + out, _mm512_maskz_mov_ps(xAxis, normalX));
+        _mm512_storeu_ps(results->normalY + out, _mm512_maskz_mov_ps(yAxis, normalY));
+    }
+
+    return i;
+}
+#endif
+
+SimdLevel GetSimdLevel(void) {
+#if defined(SIMD_X86)
+    static SimdLevel level = SIMD_COUNT;
+
+    if (level == SIMD_COUNT) {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            level = SIMD_AVX512;
+        } else if (__builtin_cpu_supports("avx2")) {
+            level = SIMD_AVX2;
+        } else {
+            level = SIMD_SSE;
+        }
+    }
+
+    return level;
+#else
+    return SIMD_SCALAR;
+#endif
+}
+
+const char *GetSimdLevelName(SimdLevel level) {
+    static const char *names[SIMD_COUNT] = {"scalar", "sse", "avx2", "avx512"};
+    return level >= 0 && level < SIMD_COUNT ? names[level] : "unknown";
+}
+
+void SweptAABBBatch(const SweptMovers *movers, const SweptTargets *targets,
+                    SweptResults *results) {
+    SweptAABBBatchLevel(GetSimdLevel(), movers, targets, results);
+}
+
+void SweptAABBBatchLevel(SimdLevel level, const SweptMovers *movers,
+                         const SweptTargets *targets, SweptResults *results) {
+    // never run a path the cpu doesn't have
+    if (level > GetSimdLevel()) {
+        level = GetSimdLevel();
+    }
+
+    for (int t = 0; t < targets->count; ++t) {
+        Rectangle target = {targets->x[t], targets->y[t], targets->width[t],
+                            targets->height[t]};
+        int base = t * movers->count;
+        int done = 0;
+
+        // widest path first, the narrower ones and the scalar path take the leftovers
+#if defined(SIMD_X86)
+        if (level >= SIMD_AVX512) {
+            done = SweptAVX512(movers, target, done, base, results);
+        }
+        if (level >= SIMD_AVX2) {
+            done = SweptAVX2(movers, target, done, base, results);
+        }
+        if (level >= SIMD_SSE) {
+            done = SweptSSE(movers, target, done, base, results);
+        }
+#endif
+        SweptScalar(movers, target, done, base, results);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef COLLISION_BATCH_H
+#define COLLISION_BATCH_H
+
+#include "pong_sim.h"
+
+// -------------------------------------------------------------------------------------
+// Enumerations
+// -------------------------------------------------------------------------------------
+typedef enum {
+    SIMD_SCALAR = 0,
+    SIMD_SSE,    // 4 lanes
+    SIMD_AVX2,   // 8 lanes
+    SIMD_AVX512, // 16 lanes
+    SIMD_COUNT
+} SimdLevel;
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+// Moving rectangles, one element per mover in every array
+typedef struct SweptMovers {
+    const float *x, *y, *width, *height;
+    const float *velX, *velY;
+    int count;
+} SweptMovers;
+
+// Static rectangles the movers are tested against
+typedef struct SweptTargets {
+    const float *x, *y, *width, *height;
+    int count;
+} SweptTargets;
+
+// Results for every (target, mover) pair, indexed by target * movers.count + mover,
+// with the same values SweptAABB returns for that pair
+typedef struct SweptResults {
+    int *hit;
+    float *time;
+    float *contactX, *contactY;
+    float *normalX, *normalY;
+} SweptResults;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+SimdLevel GetSimdLevel(void);
+const char *GetSimdLevelName(SimdLevel level);
+void SweptAABBBatch(const SweptMovers *movers, const SweptTargets *targets,
+                    SweptResults *results);
+void SweptAABBBatchLevel(SimdLevel level, const SweptMovers *movers,
+                         const SweptTargets *targets, SweptResults *results);
+
+#endif // COLLISION_BATCH_H
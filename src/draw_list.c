@@ -0,0 +1,240 @@
+#include "draw_list.h"
+
+#include <rlgl.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Stats box drawn under the perf HUD, same look
+#define DRAW_LIST_STATS_WIDTH    220
+#define DRAW_LIST_STATS_HEIGHT   22
+#define DRAW_LIST_STATS_FONTSIZE 10
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static int CompareCommands(const void *a, const void *b) {
+    unsigned long long ka = ((const DrawCommand *)a)->key;
+    unsigned long long kb = ((const DrawCommand *)b)->key;
+    return (ka > kb) - (ka < kb);
+}
+
+static int CountBatches(const DrawCommand *commands, int count) {
+    // rlgl starts a new draw call whenever the texture or the primitive changes
+    int batches = 0;
+    unsigned long long state = ~0ull;
+    for (int i = 0; i < count; ++i) {
+        unsigned long long commandState = (commands[i].key >> 32) & 0xffffff;
+        batches += commandState != state;
+        state = commandState;
+    }
+    return batches;
+}
+
+static void RasterCommand(Raster *raster, const DrawCommand *command) {
+    switch (command->type) {
+    case DRAW_RECTANGLE:
+        RasterRectangle(raster, command->rect, command->color);
+        break;
+    case DRAW_RECTANGLE_LINES:
+        RasterRectangleLines(raster, command->rect, command->size, command->color);
+        break;
+    case DRAW_LINE:
+        RasterLine(raster, command->start, command->end, command->color);
+        break;
+    case DRAW_LINE_EX:
+        RasterLineEx(raster, command->start, command->end, command->size,
+                     command->color);
+        break;
+    case DRAW_TEXT:
+        RasterText(raster, command->text, command->start.x, command->start.y,
+                   command->size, command->color);
+        break;
+    case DRAW_TEXTURE:
+        break;
+    }
+}
+
+static void FlushCommands(DrawList *list) {
+    DrawCommand *commands = (DrawCommand *)list->arena;
+
+    list->frame.commands += list->count;
+    list->frame.unsortedBatches += CountBatches(commands, list->count);
+    qsort(commands, list->count, sizeof(DrawCommand), CompareCommands);
+    list->frame.sortedBatches += CountBatches(commands, list->count);
+
+    for (int i = 0; i < list->count; ++i) {
+        DrawCommand *command = &commands[i];
+        if (list->raster != NULL) {
+            RasterCommand(list->raster, command);
+            continue;
+        }
+
+        switch (command->type) {
+        case DRAW_RECTANGLE:
+            DrawRectangleRec(command->rect, command->color);
+            break;
+        case DRAW_RECTANGLE_LINES:
+            DrawRectangleLinesEx(command->rect, command->size, command->color);
+            break;
+        case DRAW_LINE:
+            DrawLineV(command->start, command->end, command->color);
+            break;
+        case DRAW_LINE_EX:
+            DrawLineEx(command->start, command->end, command->size, command->color);
+            break;
+        case DRAW_TEXT:
+            DrawText(command->text, command->start.x, command->start.y, command->size,
+                     command->color);
+            break;
+        case DRAW_TEXTURE:
+            DrawTextureRec(command->texture, command->rect, command->start,
+                           command->color);
+            break;
+        }
+    }
+
+    list->count = 0;
+    list->commandsEnd = 0;
+    list->textStart = DRAW_LIST_ARENA_SIZE;
+}
+
+static DrawCommand *AppendCommand(DrawList *list, DrawType type, unsigned int texture,
+                                  int primitive, size_t textSize) {
+    if (list->arena == NULL) {
+        return NULL;
+    }
+
+    // a full arena submits what it holds so far, the order across the flush is kept
+    if (list->commandsEnd + sizeof(DrawCommand) + textSize > list->textStart) {
+        FlushCommands(list);
+    }
+
+    DrawCommand *command = (DrawCommand *)(list->arena + list->commandsEnd);
+    list->commandsEnd += sizeof(DrawCommand);
+    ++list->count;
+
+    // quads first, what text and rectangles draw with, so a layer carries on the
+    // batch the layer under it ended with
+    int rank = primitive == RL_QUADS ? 0 : (primitive == RL_TRIANGLES ? 1 : 2);
+    *command = (DrawCommand){0};
+    command->type = type;
+    command->key = (unsigned long long)(list->layer & 0xff) << 56 |
+                   (unsigned long long)(texture & 0xffff) << 40 |
+                   (unsigned long long)rank << 32 | list->order++;
+    return command;
+}
+
+DrawList CreateDrawList(Raster *raster) {
+    DrawList list = {0};
+    list.raster = raster;
+    list.arena = malloc(DRAW_LIST_ARENA_SIZE);
+    list.textStart = DRAW_LIST_ARENA_SIZE;
+
+    // InitWindow points shapes at the font texture, so they batch along with text
+    list.shapesTexture = GetShapesTexture().id;
+    list.fontTexture = GetFontDefault().texture.id;
+    return list;
+}
+
+void DestroyDrawList(DrawList *list) {
+    free(list->arena);
+    list->arena = NULL;
+}
+
+void DrawListLayer(DrawList *list, int layer) { list->layer = layer; }
+
+int DrawListMeasureText(const DrawList *list, const char *text, int fontSize) {
+    // the raster font is not raylib's, centered text has to be measured with it
+    return list->raster != NULL ? RasterMeasureText(text, fontSize)
+                                : MeasureText(text, fontSize);
+}
+
+void DrawListRectangle(DrawList *list, Rectangle rect, Color color) {
+    DrawCommand *command =
+        AppendCommand(list, DRAW_RECTANGLE, list->shapesTexture, RL_QUADS, 0);
+    if (command != NULL) {
+        command->rect = rect;
+        command->color = color;
+    }
+}
+
+void DrawListRectangleLines(DrawList *list, Rectangle rect, float thick, Color color) {
+    // raylib draws the thick outline as four rectangles
+    DrawCommand *command =
+        AppendCommand(list, DRAW_RECTANGLE_LINES, list->shapesTexture, RL_QUADS, 0);
+    if (command != NULL) {
+        command->rect = rect;
+        command->size = thick;
+        command->color = color;
+    }
+}
+
+void DrawListLine(DrawList *list, Vector2 start, Vector2 end, Color color) {
+    DrawCommand *command =
+        AppendCommand(list, DRAW_LINE, list->shapesTexture, RL_LINES, 0);
+    if (command != NULL) {
+        command->start = start;
+        command->end = end;
+        command->color = color;
+    }
+}
+
+void DrawListLineEx(DrawList *list, Vector2 start, Vector2 end, float thick,
+                    Color color) {
+    DrawCommand *command =
+        AppendCommand(list, DRAW_LINE_EX, list->shapesTexture, RL_TRIANGLES, 0);
+    if (command != NULL) {
+        command->start = start;
+        command->end = end;
+        command->size = thick;
+        command->color = color;
+    }
+}
+
+void DrawListText(DrawList *list, const char *text, float x, float y, int fontSize,
+                  Color color) {
+    // TextFormat buffers are reused, the text is copied
+    size_t length = strlen(text) + 1;
+    DrawCommand *command =
+        AppendCommand(list, DRAW_TEXT, list->fontTexture, RL_QUADS, length);
+    if (command != NULL) {
+        list->textStart -= length;
+        memcpy(list->arena + list->textStart, text, length);
+        command->text = (const char *)(list->arena + list->textStart);
+        command->start = (Vector2){x, y};
+        command->size = fontSize;
+        command->color = color;
+    }
+}
+
+void DrawListTexture(DrawList *list, Texture2D texture, Rectangle source,
+                     Vector2 position, Color tint) {
+    DrawCommand *command =
+        AppendCommand(list, DRAW_TEXTURE, texture.id, RL_QUADS, 0);
+    if (command != NULL) {
+        command->texture = texture;
+        command->rect = source;
+        command->start = position;
+        command->color = tint;
+    }
+}
+
+void DrawListSubmit(DrawList *list) {
+    if (list->arena == NULL) {
+        return;
+    }
+
+    FlushCommands(list);
+    list->stats = list->frame;
+    list->frame = (DrawListStats){0};
+    list->layer = 0;
+    list->order = 0;
+}
+
+void RenderDrawListStats(const DrawList *list, int x, int y) {
+    DrawRectangle(x, y, DRAW_LIST_STATS_WIDTH, DRAW_LIST_STATS_HEIGHT,
+                  Fade(BLACK, 0.75f));
+    DrawText(TextFormat("LIST %d  BATCHES %d UNSORTED -> %d", list->stats.commands,
+                        list->stats.unsortedBatches, list->stats.sortedBatches),
+             x + 10, y + 6, DRAW_LIST_STATS_FONTSIZE, GREEN);
+}
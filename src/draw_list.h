@@ -0,0 +1,79 @@
+#ifndef DRAW_LIST_H
+#define DRAW_LIST_H
+
+#include <raylib.h>
+#include <stddef.h>
+
+#include "raster.h"
+
+// Frame arena, commands fill it from the front and their text from the back
+#define DRAW_LIST_ARENA_SIZE (1 << 20)
+
+// -------------------------------------------------------------------------------------
+// Enumerations
+// -------------------------------------------------------------------------------------
+typedef enum {
+    DRAW_RECTANGLE = 0,
+    DRAW_RECTANGLE_LINES,
+    DRAW_LINE,
+    DRAW_LINE_EX,
+    DRAW_TEXT,
+    DRAW_TEXTURE
+} DrawType;
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+typedef struct DrawCommand {
+    unsigned long long key; // layer, texture, primitive, then the append order
+    DrawType type;
+    Rectangle rect;     // destination, the source rectangle for textures
+    Vector2 start, end; // line ends, text and texture position go in start
+    float size;         // line thickness or font size
+    Color color;
+    const char *text; // copied into the arena
+    Texture2D texture;
+} DrawCommand;
+
+typedef struct DrawListStats {
+    int commands;
+    int unsortedBatches; // batches raylib would have started in the append order
+    int sortedBatches;   // and once sorted
+} DrawListStats;
+
+// Draws of one frame, appended in any order and submitted once sorted. Sorting only
+// moves a command across others of the same layer, so anything drawn on top of
+// something else goes in a higher layer. A list with a raster is submitted to that
+// CPU framebuffer instead of raylib, GPU textures are skipped there.
+typedef struct DrawList {
+    Raster *raster; // NULL draws through raylib
+    unsigned char *arena;
+    size_t commandsEnd, textStart;
+    int count, layer;
+    unsigned int order;
+    unsigned int shapesTexture, fontTexture;
+
+    DrawListStats stats; // of the last submitted frame
+    DrawListStats frame; // of the frame being appended
+} DrawList;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+DrawList CreateDrawList(Raster *raster);
+void DestroyDrawList(DrawList *list);
+void DrawListLayer(DrawList *list, int layer);
+int DrawListMeasureText(const DrawList *list, const char *text, int fontSize);
+void DrawListRectangle(DrawList *list, Rectangle rect, Color color);
+void DrawListRectangleLines(DrawList *list, Rectangle rect, float thick, Color color);
+void DrawListLine(DrawList *list, Vector2 start, Vector2 end, Color color);
+void DrawListLineEx(DrawList *list, Vector2 start, Vector2 end, float thick,
+                    Color color);
+void DrawListText(DrawList *list, const char *text, float x, float y, int fontSize,
+                  Color color);
+void DrawListTexture(DrawList *list, Texture2D texture, Rectangle source,
+                     Vector2 position, Color tint);
+void DrawListSubmit(DrawList *list);
+void RenderDrawListStats(const DrawList *list, int x, int y);
+
+#endif // DRAW_LIST_H
@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "game_env.h"
+#include "tick.h"
+
+// Simulation constants
+#define DEFAULT_ENVS  256
+#define DEFAULT_STEPS 2000 // steps of the whole batch
+
+static const char *gameNames[ENV_GAME_COUNT] = {"pong", "snake"};
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+// Episodes finished by the random agent, whichever process stepped them
+typedef struct RunStats {
+    long long steps, episodes, truncated;
+    double returnSum;
+    float *returns; // of the running episode, per environment
+} RunStats;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+int RunLocal(EnvGame game, int count, int steps, unsigned int seed);
+int RunServer(const char *name, EnvGame game, int count, unsigned int seed);
+int RunTrainer(const char *name, int steps, unsigned int seed);
+void RandomActions(int *actions, int count, int actionCount, unsigned int *rng);
+void RecordStep(RunStats *stats, EnvBuffers buffers, int count);
+void PrintStats(const RunStats *stats, EnvGame game, int count, double elapsed);
+
+// -------------------------------------------------------------------------------------
+// Entrypoint
+// -------------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+    EnvGame game = ENV_PONG;
+    int count = DEFAULT_ENVS, steps = DEFAULT_STEPS;
+    unsigned int seed = 1;
+    const char *serveName = NULL, *attachName = NULL;
+    bool validArgs = true;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--game") == 0 && i + 1 < argc) {
+            ++i;
+            validArgs = validArgs && (strcmp(argv[i], gameNames[ENV_PONG]) == 0 ||
+                                      strcmp(argv[i], gameNames[ENV_SNAKE]) == 0);
+            game = strcmp(argv[i], gameNames[ENV_SNAKE]) == 0 ? ENV_SNAKE : ENV_PONG;
+        } else if (strcmp(argv[i], "--envs") == 0 && i + 1 < argc) {
+            count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--steps") == 0 && i + 1 < argc) {
+            steps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+            serveName = argv[++i];
+        } else if (strcmp(argv[i], "--attach") == 0 && i + 1 < argc) {
+            attachName = argv[++i];
+        } else {
+            validArgs = false;
+        }
+    }
+
+    if (!validArgs || count < 1 || (serveName != NULL && attachName != NULL)) {
+        fprintf(stderr,
+                "usage: %s [--game pong|snake] [--envs N] [--steps N] [--seed S]\n"
+                "          [--serve NAME | --attach NAME]\n"
+                "  steps a batch of environments with random actions, in this process\n"
+                "  or served from another one through POSIX shared memory NAME\n",
+                argv[0]);
+        return 1;
+    }
+
+    if (serveName != NULL) {
+        return RunServer(serveName, game, count, seed);
+    } else if (attachName != NULL) {
+        return RunTrainer(attachName, steps, seed);
+    }
+    return RunLocal(game, count, steps, seed);
+}
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+int RunLocal(EnvGame game, int count, int steps, unsigned int seed) {
+    // the environments on this core alone, the steps per second the trainer gets at
+    // best from one core
+    EnvBuffers buffers = CreateEnvBuffers(game, count);
+    EnvBatch env = CreateEnvBatch(game, count, seed, buffers);
+    if (env.count == 0) {
+        fprintf(stderr, "can't allocate the environments\n");
+        DestroyEnvBuffers(&buffers);
+        return 1;
+    }
+    RunStats stats = {.returns = calloc(count, sizeof(float))};
+    if (stats.returns == NULL) {
+        fprintf(stderr, "can't allocate the returns\n");
+        DestroyEnvBatch(&env);
+        DestroyEnvBuffers(&buffers);
+        return 1;
+    }
+    unsigned int rng = seed;
+
+    double start = GetSeconds();
+    for (int step = 0; step < steps; ++step) {
+        RandomActions(buffers.actions, count, env.actionCount, &rng);
+        EnvStep(&env);
+        RecordStep(&stats, buffers, count);
+    }
+    double elapsed = GetSeconds() - start;
+
+    PrintStats(&stats, game, count, elapsed);
+
+    free(stats.returns);
+    DestroyEnvBatch(&env);
+    DestroyEnvBuffers(&buffers);
+    return 0;
+}
+
+int RunServer(const char *name, EnvGame game, int count, unsigned int seed) {
+    // steps the environments whenever the trainer asks, until it closes them
+    EnvShared shared = CreateEnvShared(name, game, count);
+    if (shared.header == NULL) {
+        fprintf(stderr, "%s: can't create the shared memory, is it already served?\n",
+                shared.name);
+        return 1;
+    }
+    EnvBatch env = CreateEnvBatch(game, count, seed, shared.buffers);
+    if (env.count == 0) {
+        fprintf(stderr, "can't allocate the environments\n");
+        DestroyEnvShared(&shared);
+        return 1;
+    }
+    printf("serving:    %d %s environments on %s\n", count, gameNames[game],
+           shared.name);
+    fflush(stdout);
+
+    long long steps = 0;
+    EnvCommand command = ENV_COMMAND_NONE;
+    while (command != ENV_COMMAND_CLOSE) {
+        command = EnvSharedWait(&shared);
+        if (command == ENV_COMMAND_RESET) {
+            EnvReset(&env);
+        } else if (command == ENV_COMMAND_STEP) {
+            EnvStep(&env);
+            ++steps;
+        }
+        EnvSharedAnswer(&shared);
+    }
+    printf("closed:     after %lld steps of the batch\n", steps);
+
+    DestroyEnvBatch(&env);
+    DestroyEnvShared(&shared);
+    return 0;
+}
+
+int RunTrainer(const char *name, int steps, unsigned int seed) {
+    // stands in for a trainer, reads the buffers in place and closes the runner
+    EnvShared shared = OpenEnvShared(name);
+    if (shared.header == NULL) {
+        fprintf(stderr, "%s: no environments served there\n", shared.name);
+        return 1;
+    }
+    EnvGame game = shared.header->game;
+    int count = shared.header->count;
+    RunStats stats = {.returns = calloc(count, sizeof(float))};
+    if (stats.returns == NULL) {
+        fprintf(stderr, "can't allocate the returns\n");
+        EnvSharedCall(&shared, ENV_COMMAND_CLOSE);
+        DestroyEnvShared(&shared);
+        return 1;
+    }
+    unsigned int rng = seed;
+
+    double start = GetSeconds();
+    EnvSharedCall(&shared, ENV_COMMAND_RESET);
+    for (int step = 0; step < steps; ++step) {
+        RandomActions(shared.buffers.actions, count, shared.header->actionCount, &rng);
+        EnvSharedCall(&shared, ENV_COMMAND_STEP);
+        RecordStep(&stats, shared.buffers, count);
+    }
+    double elapsed = GetSeconds() - start;
+    EnvSharedCall(&shared, ENV_COMMAND_CLOSE);
+
+    PrintStats(&stats, game, count, elapsed);
+
+    free(stats.returns);
+    DestroyEnvShared(&shared);
+    return 0;
+}
+
+void RandomActions(int *actions, int count, int actionCount, unsigned int *rng) {
+    // xorshift32, the same actions for the same seed
+    unsigned int x = *rng != 0 ? *rng : 0x9e3779b9u;
+    for (int i = 0; i < count; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        actions[i] = (int)(x % (unsigned int)actionCount);
+    }
+    *rng = x;
+}
+
+void RecordStep(RunStats *stats, EnvBuffers buffers, int count) {
+    for (int i = 0; i < count; ++i) {
+        stats->returns[i] += buffers.rewards[i];
+        if (buffers.dones[i] != ENV_RUNNING) {
+            ++stats->episodes;
+            stats->truncated += buffers.dones[i] == ENV_TRUNCATED;
+            stats->returnSum += stats->returns[i];
+            stats->returns[i] = 0.0f;
+        }
+    }
+    stats->steps += count;
+}
+
+void PrintStats(const RunStats *stats, EnvGame game, int count, double elapsed) {
+    printf("game:       %s, %d environments, %d observations, %d actions\n",
+           gameNames[game], count, EnvObservationSize(game), EnvActionCount(game));
+    printf("steps:      %lld\n", stats->steps);
+    printf("episodes:   %lld (%lld cut), mean return %.2f\n", stats->episodes,
+           stats->truncated,
+           stats->episodes > 0 ? stats->returnSum / stats->episodes : 0.0);
+    printf("elapsed:    %.3f s\n", elapsed);
+    printf("steps/s:    %.0f\n", elapsed > 0.0 ? stats->steps / elapsed : 0.0);
+}
+
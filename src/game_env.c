@@ -0,0 +1,393 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "game_env.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char sharedMagic[4] = {'E', 'N', 'V', 'B'};
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static unsigned int EpisodeSeed(const EnvBatch *env, int index) {
+    // different for every episode of every environment
+    return env->seed + (unsigned int)index +
+           env->episodes[index] * (unsigned int)env->count;
+}
+
+static float *Observation(const EnvBatch *env, int index) {
+    return env->buffers.observations + (size_t)index * env->observationSize;
+}
+
+static void ObservePong(const PongState *state, float *observation) {
+    // the arena scaled to [0,1], directions as they are and the speed in serves
+    observation[0] = state->ball.rect.x / SCREEN_WIDTH;
+    observation[1] = state->ball.rect.y / SCREEN_HEIGHT;
+    observation[2] = state->ball.dir.x;
+    observation[3] = state->ball.dir.y;
+    observation[4] = state->ball.speed / BALL_INITIAL_SPEED;
+    observation[5] = state->leftPaddle.rect.y / SCREEN_HEIGHT;
+    observation[6] = state->rightPaddle.rect.y / SCREEN_HEIGHT;
+    observation[7] = (float)(state->leftScore - state->rightScore) / SCORE_MAX;
+}
+
+static void ResetPong(EnvBatch *env, int index) {
+    PongState *state = &env->pongs[index];
+    PongInit(state, EpisodeSeed(env, index), CONTROL_PLAYER, CONTROL_IA);
+    ++env->episodes[index];
+    env->steps[index] = 0;
+    ObservePong(state, Observation(env, index));
+}
+
+static void StepPong(EnvBatch *env, int index, int action) {
+    PongState *state = &env->pongs[index];
+    PongInput input = {0};
+    if (action == ENV_PONG_UP) {
+        input.leftMove = -1.0f;
+    } else if (action == ENV_PONG_DOWN) {
+        input.leftMove = 1.0f;
+    }
+
+    // a point for every goal, one against for every goal taken
+    float reward = 0.0f;
+    for (int tick = 0; tick < ENV_PONG_TICKS && !PongIsOver(state); ++tick) {
+        PongStep(state, input, PONG_TICK_DT);
+        reward += (state->events & PONG_EVENT_SCORE_LEFT) != 0;
+        reward -= (state->events & PONG_EVENT_SCORE_RIGHT) != 0;
+    }
+
+    EnvDone done = ENV_RUNNING;
+    if (PongIsOver(state)) {
+        done = ENV_TERMINATED;
+    } else if (++env->steps[index] >= ENV_PONG_STEPS_MAX) {
+        done = ENV_TRUNCATED;
+    }
+    env->buffers.rewards[index] = reward;
+    env->buffers.dones[index] = done;
+
+    if (done != ENV_RUNNING) {
+        ResetPong(env, index);
+    } else {
+        ObservePong(state, Observation(env, index));
+    }
+}
+
+static void ObserveSnake(const SnakeState *state, float *board) {
+    for (int cell = 0; cell < GRID_CELLS; ++cell) {
+        board[cell] = ENV_CELL_EMPTY;
+    }
+    for (int i = 0; i < state->length - 1; ++i) {
+        board[SnakeBodyCell(state, i)] = ENV_CELL_BODY;
+    }
+    board[SnakeHead(state)] = ENV_CELL_HEAD;
+    if (state->apple >= 0) {
+        board[state->apple] = ENV_CELL_APPLE;
+    }
+}
+
+static void ResetSnake(EnvBatch *env, int index) {
+    SnakeState *state = &env->snakes[index];
+    SnakeInit(state, EpisodeSeed(env, index));
+    ++env->episodes[index];
+    env->steps[index] = 0;
+    env->hungry[index] = 0;
+    ObserveSnake(state, Observation(env, index));
+}
+
+static void StepSnake(EnvBatch *env, int index, int action) {
+    SnakeState *state = &env->snakes[index];
+    state->dir = action > DIR_NONE && action < DIR_COUNT ? (Direction)action : DIR_NONE;
+    SnakeStep(state);
+
+    // a point for every apple, one against for running into the body. A body that
+    // couldn't grow is no fault of the agent, the episode is only cut.
+    float reward = 0.0f;
+    EnvDone done = ENV_RUNNING;
+    if (state->events & SNAKE_EVENT_NO_MEMORY) {
+        done = ENV_TRUNCATED;
+    } else if (state->events & SNAKE_EVENT_DEAD) {
+        reward = -1.0f;
+        done = ENV_TERMINATED;
+    } else if (state->events & SNAKE_EVENT_EAT) {
+        reward = 1.0f;
+        env->hungry[index] = 0;
+        done = state->events & SNAKE_EVENT_WIN ? ENV_TERMINATED : ENV_RUNNING;
+    } else if (++env->hungry[index] > ENV_SNAKE_STALL_STEPS) {
+        done = ENV_TRUNCATED;
+    }
+    ++env->steps[index];
+    env->buffers.rewards[index] = reward;
+    env->buffers.dones[index] = done;
+
+    if (done != ENV_RUNNING) {
+        ResetSnake(env, index);
+        return;
+    }
+
+    // only the cells the step changed, the head may have taken the old tail cell
+    float *board = Observation(env, index);
+    if (!(state->events & SNAKE_EVENT_EAT)) {
+        board[state->prevTail] = ENV_CELL_EMPTY;
+    }
+    board[state->prevHead] = ENV_CELL_BODY;
+    board[SnakeHead(state)] = ENV_CELL_HEAD;
+    if (state->events & SNAKE_EVENT_EAT) {
+        board[state->apple] = ENV_CELL_APPLE;
+    }
+}
+
+static size_t AlignShared(size_t offset) {
+    return (offset + ENV_SHARED_ALIGN - 1) / ENV_SHARED_ALIGN * ENV_SHARED_ALIGN;
+}
+
+static void SharedName(const char *name, char *sharedName) {
+    // POSIX shared memory names start with a slash
+    snprintf(sharedName, ENV_SHARED_NAME_SIZE, "%s%s", name[0] == '/' ? "" : "/", name);
+}
+
+static EnvBuffers SharedBuffers(EnvSharedHeader *header) {
+    unsigned char *base = (unsigned char *)header;
+    return (EnvBuffers){.observations = (float *)(base + header->observations),
+                        .rewards = (float *)(base + header->rewards),
+                        .dones = base + header->dones,
+                        .actions = (int *)(base + header->actions)};
+}
+
+static void WaitShared(sem_t *sem) {
+    while (sem_wait(sem) != 0 && errno == EINTR) {
+    }
+}
+
+EnvBatch CreateEnvBatch(EnvGame game, int count, unsigned int seed,
+                        EnvBuffers buffers) {
+    EnvBatch env = {.game = game,
+                    .count = count,
+                    .observationSize = EnvObservationSize(game),
+                    .actionCount = EnvActionCount(game),
+                    .seed = seed,
+                    .buffers = buffers};
+
+    // the snakes are zeroed first, so a batch that fails halfway destroys cleanly
+    if (game == ENV_PONG) {
+        env.pongs = malloc(count * sizeof(PongState));
+    } else {
+        env.snakes = calloc(count, sizeof(SnakeState));
+    }
+    env.steps = calloc(count, sizeof(int));
+    env.hungry = calloc(count, sizeof(int));
+    env.episodes = calloc(count, sizeof(unsigned int));
+    bool created = (env.pongs != NULL || env.snakes != NULL) && env.steps != NULL &&
+                   env.hungry != NULL && env.episodes != NULL &&
+                   buffers.observations != NULL;
+    for (int i = 0; created && game == ENV_SNAKE && i < count; ++i) {
+        env.snakes[i] = CreateSnakeState(seed);
+        created = env.snakes[i].body != NULL;
+    }
+    if (!created) {
+        DestroyEnvBatch(&env);
+        return env;
+    }
+
+    EnvReset(&env);
+    return env;
+}
+
+void DestroyEnvBatch(EnvBatch *env) {
+    if (env->snakes != NULL) {
+        for (int i = 0; i < env->count; ++i) {
+            DestroySnakeState(&env->snakes[i]);
+        }
+    }
+    free(env->pongs);
+    free(env->snakes);
+    free(env->steps);
+    free(env->hungry);
+    free(env->episodes);
+    *env = (EnvBatch){0};
+}
+
+void EnvReset(EnvBatch *env) {
+    // every environment back to its first episode, so a reset batch replays the same
+    for (int i = 0; i < env->count; ++i) {
+        env->episodes[i] = 0;
+        if (env->game == ENV_PONG) {
+            ResetPong(env, i);
+        } else {
+            ResetSnake(env, i);
+        }
+        env->buffers.rewards[i] = 0.0f;
+        env->buffers.dones[i] = ENV_RUNNING;
+    }
+}
+
+void EnvStep(EnvBatch *env) {
+    const int *actions = env->buffers.actions;
+
+    if (env->game == ENV_PONG) {
+        for (int i = 0; i < env->count; ++i) {
+            StepPong(env, i, actions[i]);
+        }
+    } else {
+        for (int i = 0; i < env->count; ++i) {
+            StepSnake(env, i, actions[i]);
+        }
+    }
+}
+
+int EnvObservationSize(EnvGame game) {
+    return game == ENV_PONG ? ENV_PONG_OBSERVATIONS : ENV_SNAKE_OBSERVATIONS;
+}
+
+int EnvActionCount(EnvGame game) {
+    return game == ENV_PONG ? ENV_PONG_ACTIONS : ENV_SNAKE_ACTIONS;
+}
+
+EnvBuffers CreateEnvBuffers(EnvGame game, int count) {
+    EnvBuffers buffers = {
+        .observations = calloc((size_t)count * EnvObservationSize(game), sizeof(float)),
+        .rewards = calloc(count, sizeof(float)),
+        .dones = calloc(count, sizeof(unsigned char)),
+        .actions = calloc(count, sizeof(int))};
+    if (buffers.observations == NULL || buffers.rewards == NULL ||
+        buffers.dones == NULL || buffers.actions == NULL) {
+        DestroyEnvBuffers(&buffers);
+    }
+    return buffers;
+}
+
+void DestroyEnvBuffers(EnvBuffers *buffers) {
+    free(buffers->observations);
+    free(buffers->rewards);
+    free(buffers->dones);
+    free(buffers->actions);
+    *buffers = (EnvBuffers){0};
+}
+
+EnvShared CreateEnvShared(const char *name, EnvGame game, int count) {
+    EnvShared shared = {0};
+    SharedName(name, shared.name);
+    if (count < 1) {
+        return shared;
+    }
+
+    // the layout goes in the header, the trainer finds the buffers from it
+    EnvSharedHeader layout = {.version = ENV_SHARED_VERSION,
+                              .game = game,
+                              .count = count,
+                              .observationSize = EnvObservationSize(game),
+                              .actionCount = EnvActionCount(game)};
+    memcpy(layout.magic, sharedMagic, sizeof(sharedMagic));
+    size_t offset = AlignShared(sizeof(EnvSharedHeader));
+    layout.observations = offset;
+    offset += (size_t)count * layout.observationSize * sizeof(float);
+    offset = AlignShared(offset);
+    layout.rewards = offset;
+    offset = AlignShared(offset + count * sizeof(float));
+    layout.dones = offset;
+    offset = AlignShared(offset + count * sizeof(unsigned char));
+    layout.actions = offset;
+    offset += count * sizeof(int);
+    layout.size = offset;
+
+    // a name left by a runner that didn't exit cleanly is not taken over
+    int fd = shm_open(shared.name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        return shared;
+    }
+    void *data = MAP_FAILED;
+    if (ftruncate(fd, offset) == 0) {
+        data = mmap(NULL, offset, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) {
+        shm_unlink(shared.name);
+        return shared;
+    }
+
+    shared.header = data;
+    *shared.header = layout;
+    sem_init(&shared.header->request, 1, 0);
+    sem_init(&shared.header->response, 1, 0);
+    shared.size = offset;
+    shared.owner = true;
+    shared.buffers = SharedBuffers(shared.header);
+
+    return shared;
+}
+
+EnvShared OpenEnvShared(const char *name) {
+    EnvShared shared = {0};
+    SharedName(name, shared.name);
+
+    int fd = shm_open(shared.name, O_RDWR, 0);
+    if (fd < 0) {
+        return shared;
+    }
+    struct stat info;
+    void *data = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(EnvSharedHeader)) {
+        data = mmap(NULL, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) {
+        return shared;
+    }
+
+    // a block from another version or cut short is left alone
+    EnvSharedHeader *header = data;
+    size_t size = info.st_size;
+    if (memcmp(header->magic, sharedMagic, sizeof(sharedMagic)) != 0 ||
+        header->version != ENV_SHARED_VERSION || header->size != size ||
+        header->game < 0 || header->game >= ENV_GAME_COUNT || header->count < 1 ||
+        header->actions + header->count * sizeof(int) > size) {
+        munmap(data, size);
+        return shared;
+    }
+
+    shared.header = header;
+    shared.size = size;
+    shared.buffers = SharedBuffers(header);
+    return shared;
+}
+
+void DestroyEnvShared(EnvShared *shared) {
+    if (shared->header != NULL) {
+        if (shared->owner) {
+            sem_destroy(&shared->header->request);
+            sem_destroy(&shared->header->response);
+        }
+        munmap(shared->header, shared->size);
+    }
+    if (shared->owner) {
+        shm_unlink(shared->name);
+    }
+
+    shared->header = NULL;
+    shared->size = 0;
+    shared->owner = false;
+    shared->buffers = (EnvBuffers){0};
+}
+
+EnvCommand EnvSharedWait(EnvShared *shared) {
+    // runner side, blocks until the trainer posts a command
+    WaitShared(&shared->header->request);
+    return shared->header->command;
+}
+
+void EnvSharedAnswer(EnvShared *shared) {
+    sem_post(&shared->header->response);
+}
+
+void EnvSharedCall(EnvShared *shared, EnvCommand command) {
+    // trainer side, the buffers are written when it returns
+    shared->header->command = command;
+    sem_post(&shared->header->request);
+    WaitShared(&shared->header->response);
+}
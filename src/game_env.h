@@ -0,0 +1,142 @@
+#ifndef GAME_ENV_H
+#define GAME_ENV_H
+
+#include <semaphore.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "pong_sim.h"
+#include "snake_sim.h"
+
+// Pong, the agent plays the left paddle against the hard IA. A step is one 60 Hz
+// frame of simulation ticks, a match longer than the limit is cut.
+#define ENV_PONG_OBSERVATIONS 8
+#define ENV_PONG_TICKS        4
+#define ENV_PONG_STEPS_MAX    (60 * 60 * 30)
+
+// Snake, a step moves the snake one cell. The board is the observation, one value
+// per cell row by row; a snake that goes this many steps without eating is cut.
+#define ENV_SNAKE_OBSERVATIONS GRID_CELLS
+#define ENV_SNAKE_STALL_STEPS  (4 * GRID_CELLS)
+
+// Snake actions are the Direction values, DIR_NONE keeps going
+#define ENV_SNAKE_ACTIONS DIR_COUNT
+
+// Snake board values
+#define ENV_CELL_EMPTY 0.0f
+#define ENV_CELL_BODY  0.5f
+#define ENV_CELL_HEAD  1.0f
+#define ENV_CELL_APPLE -1.0f
+
+// Shared memory block, the buffers start at offsets aligned to a cache line
+#define ENV_SHARED_VERSION   1
+#define ENV_SHARED_ALIGN     64
+#define ENV_SHARED_NAME_SIZE 64
+
+// -------------------------------------------------------------------------------------
+// Enumerations
+// -------------------------------------------------------------------------------------
+typedef enum {
+    ENV_PONG = 0,
+    ENV_SNAKE,
+    ENV_GAME_COUNT
+} EnvGame;
+
+// Pong actions, anything out of range is taken as the first one in both games
+typedef enum {
+    ENV_PONG_STAY = 0,
+    ENV_PONG_UP,
+    ENV_PONG_DOWN,
+    ENV_PONG_ACTIONS
+} EnvPongAction;
+
+// Done flag of an environment after a step, it has already started over
+typedef enum {
+    ENV_RUNNING = 0,
+    ENV_TERMINATED, // the match or the game ended
+    ENV_TRUNCATED   // cut at the step limit
+} EnvDone;
+
+// Requests a trainer sends to the process running the environments
+typedef enum {
+    ENV_COMMAND_NONE = 0,
+    ENV_COMMAND_RESET,
+    ENV_COMMAND_STEP,
+    ENV_COMMAND_CLOSE
+} EnvCommand;
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+// Contiguous buffers owned by the caller, every environment at its index
+typedef struct EnvBuffers {
+    float *observations;  // count * observation size
+    float *rewards;       // count
+    unsigned char *dones; // count, EnvDone
+    int *actions;         // count, read by every step
+} EnvBuffers;
+
+// A batch of environments of one game stepped together. Reset and step write
+// straight into the buffers given at creation; an environment that is done starts a
+// new episode in the same step, the observation is then its first one. Episodes are
+// seeded from the batch seed, the environment index and the episode count, so a
+// batch plays the same whatever the other environments do. A batch that can't be
+// allocated, or is given buffers that weren't, is created without environments.
+typedef struct EnvBatch {
+    EnvGame game;
+    int count;
+    int observationSize, actionCount;
+    unsigned int seed;
+    EnvBuffers buffers;
+
+    PongState *pongs;
+    SnakeState *snakes;
+    int *steps;             // in the current episode
+    int *hungry;            // snake steps since the last apple
+    unsigned int *episodes; // started by every environment
+} EnvBatch;
+
+// Start of the shared memory block. A trainer posts a command on request and waits
+// on response; the buffers are only touched by the side that holds the turn.
+typedef struct EnvSharedHeader {
+    char magic[4]; // "ENVB"
+    int version;
+    int game, count, observationSize, actionCount;
+    unsigned int observations, rewards, dones, actions; // offsets from the start
+    unsigned int size;
+    sem_t request, response; // shared between the processes
+    int command;             // EnvCommand
+} EnvSharedHeader;
+
+// The buffers of a batch in POSIX shared memory, so a trainer in another process
+// reads the observations where the environments wrote them
+typedef struct EnvShared {
+    EnvSharedHeader *header; // the mapped block
+    size_t size;
+    char name[ENV_SHARED_NAME_SIZE];
+    bool owner; // created it, unlinks the name when destroyed
+    EnvBuffers buffers;
+} EnvShared;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+// Environments
+EnvBatch CreateEnvBatch(EnvGame game, int count, unsigned int seed, EnvBuffers buffers);
+void DestroyEnvBatch(EnvBatch *env);
+void EnvReset(EnvBatch *env);
+void EnvStep(EnvBatch *env);
+int EnvObservationSize(EnvGame game);
+int EnvActionCount(EnvGame game);
+EnvBuffers CreateEnvBuffers(EnvGame game, int count);
+void DestroyEnvBuffers(EnvBuffers *buffers);
+
+// Shared memory
+EnvShared CreateEnvShared(const char *name, EnvGame game, int count);
+EnvShared OpenEnvShared(const char *name);
+void DestroyEnvShared(EnvShared *shared);
+EnvCommand EnvSharedWait(EnvShared *shared);
+void EnvSharedAnswer(EnvShared *shared);
+void EnvSharedCall(EnvShared *shared, EnvCommand command);
+
+#endif // GAME_ENV_H
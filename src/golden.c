@@ -0,0 +1,76 @@
+#include "golden.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+GoldenSet LoadGoldenSet(const char *path) {
+    GoldenSet set = {0};
+    set.path = path;
+
+    // a missing file is a first run, every frame is missing from it
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return set;
+    }
+
+    char name[GOLDEN_NAME_SIZE];
+    unsigned long long hash;
+    while (set.count < GOLDEN_FRAMES_MAX &&
+           fscanf(file, "%47s %llx", name, &hash) == 2) {
+        strcpy(set.names[set.count], name);
+        set.hashes[set.count++] = hash;
+    }
+    fclose(file);
+
+    return set;
+}
+
+bool SaveGoldenSet(const GoldenSet *set) {
+    FILE *file = fopen(set->path, "w");
+    if (file == NULL) {
+        return false;
+    }
+
+    for (int i = 0; i < set->count; ++i) {
+        fprintf(file, "%s %016llx\n", set->names[i], set->hashes[i]);
+    }
+
+    return fclose(file) == 0;
+}
+
+GoldenResult CheckGolden(GoldenSet *set, const char *name, const Raster *raster,
+                         bool update) {
+    unsigned long long hash = RasterHash(raster);
+
+    int index = 0;
+    while (index < set->count && strcmp(set->names[index], name) != 0) {
+        ++index;
+    }
+
+    if (index == set->count) {
+        ++set->missing;
+        if (update && set->count < GOLDEN_FRAMES_MAX) {
+            snprintf(set->names[set->count], GOLDEN_NAME_SIZE, "%s", name);
+            set->hashes[set->count++] = hash;
+        }
+        return GOLDEN_MISSING;
+    }
+
+    if (set->hashes[index] == hash) {
+        ++set->matched;
+        return GOLDEN_MATCH;
+    }
+
+    ++set->mismatched;
+    if (update) {
+        set->hashes[index] = hash;
+    } else {
+        char framePath[512];
+        snprintf(framePath, sizeof(framePath), "%s.%s.ppm", set->path, name);
+        ExportRaster(raster, framePath);
+    }
+    return GOLDEN_MISMATCH;
+}
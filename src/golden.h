@@ -0,0 +1,42 @@
+#ifndef GOLDEN_H
+#define GOLDEN_H
+
+#include <stdbool.h>
+
+#include "raster.h"
+
+// Frames a golden file holds at most, and the longest frame name
+#define GOLDEN_FRAMES_MAX 128
+#define GOLDEN_NAME_SIZE  48
+
+// -------------------------------------------------------------------------------------
+// Enumerations
+// -------------------------------------------------------------------------------------
+typedef enum {
+    GOLDEN_MATCH = 0,
+    GOLDEN_MISMATCH, // the frame is written next to the golden file for a look
+    GOLDEN_MISSING   // no hash recorded for this frame yet
+} GoldenResult;
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+// Pixel exact references for CPU rendered frames, kept as one hash per frame in a
+// text file so a change shows up in a diff without storing the images.
+typedef struct GoldenSet {
+    const char *path;
+    char names[GOLDEN_FRAMES_MAX][GOLDEN_NAME_SIZE];
+    unsigned long long hashes[GOLDEN_FRAMES_MAX];
+    int count;
+    int matched, mismatched, missing;
+} GoldenSet;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+GoldenSet LoadGoldenSet(const char *path);
+bool SaveGoldenSet(const GoldenSet *set);
+GoldenResult CheckGolden(GoldenSet *set, const char *name, const Raster *raster,
+                         bool update);
+
+#endif // GOLDEN_H
@@ -0,0 +1,32 @@
+#include "input_queue.h"
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+bool InputQueuePush(InputQueue *queue, InputEvent event) {
+    // the acquire pairs with the consumer release, the slot is free once tail moved
+    unsigned int head = queue->head;
+    unsigned int tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+    if (head - tail == INPUT_QUEUE_SIZE) {
+        return false;
+    }
+
+    queue->events[head & (INPUT_QUEUE_SIZE - 1)] = event;
+    __atomic_store_n(&queue->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool InputQueuePeek(InputQueue *queue, InputEvent *event) {
+    unsigned int tail = queue->tail;
+    unsigned int head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    if (tail == head) {
+        return false;
+    }
+
+    *event = queue->events[tail & (INPUT_QUEUE_SIZE - 1)];
+    return true;
+}
+
+void InputQueuePop(InputQueue *queue) {
+    __atomic_store_n(&queue->tail, queue->tail + 1, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,32 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include <stdbool.h>
+
+// Events the queue holds, a power of two
+#define INPUT_QUEUE_SIZE 1024
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+typedef struct InputEvent {
+    double time;       // seconds, CLOCK_MONOTONIC
+    unsigned int keys; // InputKey flags held from this time on
+} InputEvent;
+
+// Lock-free ring for one producer thread and one consumer thread. Each index is only
+// written by its own side, the events array keeps them on separate cache lines.
+typedef struct InputQueue {
+    unsigned int head; // next slot to write, owned by the producer
+    InputEvent events[INPUT_QUEUE_SIZE];
+    unsigned int tail; // next slot to read, owned by the consumer
+} InputQueue;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+bool InputQueuePush(InputQueue *queue, InputEvent event);
+bool InputQueuePeek(InputQueue *queue, InputEvent *event);
+void InputQueuePop(InputQueue *queue);
+
+#endif // INPUT_QUEUE_H
@@ -0,0 +1,218 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "input_sampler.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "tick.h"
+
+#if defined(__linux__)
+#include <linux/input.h>
+#include <sys/ioctl.h>
+#endif
+
+// Longest wait for a key event, the sampler loop runs at 1 kHz at least
+#define INPUT_POLL_MS 1
+
+// Event devices scanned for keyboards, /dev/input/eventN
+#define INPUT_EVENT_DEVICES 32
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+#if defined(__linux__)
+static unsigned int KeyFlag(int code) {
+    switch (code) {
+    case KEY_UP:
+        return INPUT_KEY_UP;
+    case KEY_DOWN:
+        return INPUT_KEY_DOWN;
+    case KEY_W:
+        return INPUT_KEY_W;
+    case KEY_S:
+        return INPUT_KEY_S;
+    default:
+        return 0;
+    }
+}
+
+static bool IsKeyboard(int fd) {
+    unsigned char bits[KEY_MAX / 8 + 1] = {0};
+    if (ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(bits)), bits) < 0) {
+        return false;
+    }
+
+    // only devices with every key the game reads, mice and power buttons are skipped
+    int codes[] = {KEY_UP, KEY_DOWN, KEY_W, KEY_S};
+    for (int i = 0; i < 4; ++i) {
+        if (!(bits[codes[i] / 8] & (1 << (codes[i] % 8)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void *SamplerMain(void *arg) {
+    InputSampler *sampler = arg;
+    struct pollfd fds[INPUT_DEVICES_MAX];
+    for (int i = 0; i < sampler->deviceCount; ++i) {
+        fds[i] = (struct pollfd){.fd = sampler->devices[i], .events = POLLIN};
+    }
+
+    while (__atomic_load_n(&sampler->running, __ATOMIC_ACQUIRE)) {
+        poll(fds, sampler->deviceCount, INPUT_POLL_MS);
+
+        for (int i = 0; i < sampler->deviceCount; ++i) {
+            struct input_event events[64];
+            ssize_t size;
+            while ((size = read(fds[i].fd, events, sizeof(events))) > 0) {
+                for (size_t j = 0; j < size / sizeof(struct input_event); ++j) {
+                    struct input_event *event = &events[j];
+                    unsigned int flag = KeyFlag(event->code);
+                    if (event->type != EV_KEY || event->value == 2 || flag == 0) {
+                        continue;
+                    }
+
+                    // value is 1 on press and 0 on release, 2 are autorepeats
+                    unsigned int keys = event->value ? sampler->sampledKeys | flag
+                                                     : sampler->sampledKeys & ~flag;
+                    double time =
+                        event->input_event_sec + event->input_event_usec / 1e6;
+                    InputSamplerPush(sampler, keys, time);
+                }
+            }
+        }
+
+        // retries the latest keys if the queue was full
+        InputSamplerPush(sampler, sampler->sampledKeys, sampler->sampledTime);
+    }
+
+    return NULL;
+}
+#endif
+
+static int CompareFloat(const void *a, const void *b) {
+    float fa = *(const float *)a, fb = *(const float *)b;
+    return (fa > fb) - (fa < fb);
+}
+
+InputSampler CreateInputSampler(void) {
+    InputSampler sampler = {0};
+
+#if defined(__linux__)
+    // needs read access to the devices, usually membership of the input group
+    for (int i = 0; i < INPUT_EVENT_DEVICES && sampler.deviceCount < INPUT_DEVICES_MAX;
+         ++i) {
+        char path[32];
+        snprintf(path, sizeof(path), "/dev/input/event%d", i);
+        int fd = open(path, O_RDONLY | O_NONBLOCK);
+        if (fd < 0) {
+            continue;
+        }
+
+        // timestamps on the same clock as GetSeconds
+        int clock = CLOCK_MONOTONIC;
+        if (!IsKeyboard(fd) || ioctl(fd, EVIOCSCLOCKID, &clock) != 0) {
+            close(fd);
+            continue;
+        }
+        sampler.devices[sampler.deviceCount++] = fd;
+    }
+#endif
+
+    return sampler;
+}
+
+bool StartInputSampler(InputSampler *sampler) {
+#if defined(__linux__)
+    if (sampler->deviceCount == 0) {
+        return false;
+    }
+
+    sampler->running = true;
+    if (pthread_create(&sampler->thread, NULL, SamplerMain, sampler) != 0) {
+        sampler->running = false;
+    }
+#endif
+    return sampler->running;
+}
+
+void DestroyInputSampler(InputSampler *sampler) {
+    if (sampler->running) {
+        __atomic_store_n(&sampler->running, false, __ATOMIC_RELEASE);
+        pthread_join(sampler->thread, NULL);
+    }
+
+    for (int i = 0; i < sampler->deviceCount; ++i) {
+        close(sampler->devices[i]);
+    }
+    sampler->deviceCount = 0;
+}
+
+void InputSamplerPush(InputSampler *sampler, unsigned int keys, double time) {
+    if (keys != sampler->sampledKeys) {
+        sampler->sampledKeys = keys;
+        sampler->sampledTime = time;
+    }
+
+    // a full queue keeps the latest keys until the consumer makes room
+    InputEvent event = {.time = sampler->sampledTime, .keys = sampler->sampledKeys};
+    if (sampler->sampledKeys != sampler->pushedKeys &&
+        InputQueuePush(&sampler->queue, event)) {
+        sampler->pushedKeys = sampler->sampledKeys;
+    }
+}
+
+unsigned int InputSamplerKeysAt(InputSampler *sampler, double time) {
+    InputEvent event;
+    double now = GetSeconds();
+
+    while (InputQueuePeek(&sampler->queue, &event) && event.time <= time) {
+        sampler->keys = event.keys;
+        sampler->latencies[sampler->latencyCount++ % INPUT_LATENCY_SAMPLES] =
+            now - event.time;
+        InputQueuePop(&sampler->queue);
+    }
+
+    return sampler->keys;
+}
+
+void InputSamplerFlush(InputSampler *sampler) {
+    InputEvent event;
+    while (InputQueuePeek(&sampler->queue, &event)) {
+        sampler->keys = event.keys;
+        InputQueuePop(&sampler->queue);
+    }
+}
+
+void InputSamplerReport(const InputSampler *sampler) {
+    int count = sampler->latencyCount < INPUT_LATENCY_SAMPLES ? sampler->latencyCount
+                                                              : INPUT_LATENCY_SAMPLES;
+    if (count == 0) {
+        printf("input latency: no key events reached the simulation\n");
+        return;
+    }
+
+    float *sorted = malloc(count * sizeof(float));
+    if (sorted == NULL) {
+        printf("input latency: no memory to sort %d events\n", count);
+        return;
+    }
+    memcpy(sorted, sampler->latencies, count * sizeof(float));
+    qsort(sorted, count, sizeof(float), CompareFloat);
+
+    printf("input latency (%s, %d events): p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, "
+           "max %.2f ms\n",
+           sampler->running ? "sampler thread" : "frame polling", count,
+           1000.0f * sorted[(int)(0.50f * (count - 1))],
+           1000.0f * sorted[(int)(0.90f * (count - 1))],
+           1000.0f * sorted[(int)(0.99f * (count - 1))], 1000.0f * sorted[count - 1]);
+
+    free(sorted);
+}
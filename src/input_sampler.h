@@ -0,0 +1,59 @@
+#ifndef INPUT_SAMPLER_H
+#define INPUT_SAMPLER_H
+
+#include <pthread.h>
+#include <stdbool.h>
+
+#include "input_queue.h"
+
+// Keyboards read at most by the sampler thread
+#define INPUT_DEVICES_MAX 8
+
+// Latencies kept for the percentiles, the most recent ones
+#define INPUT_LATENCY_SAMPLES 4096
+
+// -------------------------------------------------------------------------------------
+// Enumerations
+// -------------------------------------------------------------------------------------
+typedef enum {
+    INPUT_KEY_UP = 1 << 0,
+    INPUT_KEY_DOWN = 1 << 1,
+    INPUT_KEY_W = 1 << 2,
+    INPUT_KEY_S = 1 << 3
+} InputKey;
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+// Timestamped key changes, read by a thread straight from the evdev keyboards with
+// the kernel timestamps. Without access to them the game pushes the keys it polls
+// every frame through the same queue, so the consumer doesn't change.
+typedef struct InputSampler {
+    InputQueue queue;
+    pthread_t thread;
+    bool running;
+    int devices[INPUT_DEVICES_MAX];
+    int deviceCount;
+
+    // producer side
+    unsigned int sampledKeys, pushedKeys;
+    double sampledTime;
+
+    // consumer side
+    unsigned int keys;
+    float latencies[INPUT_LATENCY_SAMPLES]; // seconds from the event to its tick
+    int latencyCount;
+} InputSampler;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+InputSampler CreateInputSampler(void);
+bool StartInputSampler(InputSampler *sampler);
+void DestroyInputSampler(InputSampler *sampler);
+void InputSamplerPush(InputSampler *sampler, unsigned int keys, double time);
+unsigned int InputSamplerKeysAt(InputSampler *sampler, double time);
+void InputSamplerFlush(InputSampler *sampler);
+void InputSamplerReport(const InputSampler *sampler);
+
+#endif // INPUT_SAMPLER_H
@@ -0,0 +1,181 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "netplay.h"
+#include "pong_sim.h"
+#include "tick.h"
+
+// Simulation constants
+#define DEFAULT_SECONDS 10
+#define DEFAULT_PORT    7777
+#define FRAME_RATE      60
+
+// Seconds both ends get to agree once they stop advancing
+#define SETTLE_TIMEOUT 5.0
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+void SleepUntil(double time);
+unsigned int RandomButtons(unsigned int *rngState, unsigned int buttons);
+
+// -------------------------------------------------------------------------------------
+// Entrypoint
+// -------------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+    float seconds = DEFAULT_SECONDS;
+    NetConfig host = {.port = DEFAULT_PORT, .seed = 1, .inputDelay = 2};
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = strtof(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            host.port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            host.seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--delay") == 0 && i + 1 < argc) {
+            host.inputDelay = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--latency") == 0 && i + 1 < argc) {
+            host.latency = strtof(argv[++i], NULL) / 1000.0f;
+        } else if (strcmp(argv[i], "--jitter") == 0 && i + 1 < argc) {
+            host.jitter = strtof(argv[++i], NULL) / 1000.0f;
+        } else if (strcmp(argv[i], "--loss") == 0 && i + 1 < argc) {
+            host.loss = strtof(argv[++i], NULL) / 100.0f;
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--seconds S] [--port P] [--seed S] [--delay TICKS]\n"
+                    "          [--latency MS] [--jitter MS] [--loss PERCENT]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    // both ends live in this process and talk through the loopback interface
+    NetConfig peer = host;
+    peer.port = 0;
+    peer.peerHost = "127.0.0.1";
+    peer.peerPort = host.port;
+    peer.seed = host.seed + 1;
+
+    NetPlay *net = malloc(2 * sizeof(NetPlay));
+    if (net == NULL) {
+        fprintf(stderr, "can't allocate the loopback ends\n");
+        return 1;
+    }
+    net[0] = CreateNetPlay(host);
+    net[1] = CreateNetPlay(peer);
+    if (net[0].status == NET_CLOSED || net[1].status == NET_CLOSED) {
+        // the end that did open is closed again, the other one is already closed
+        fprintf(stderr, "can't open the loopback sockets on port %d\n", host.port);
+        DestroyNetPlay(&net[0]);
+        DestroyNetPlay(&net[1]);
+        free(net);
+        return 1;
+    }
+
+    PongState state[2] = {0};
+    unsigned int buttons[2] = {0}, rngState[2] = {host.seed, host.seed ^ 0x5bd1e995u};
+    int ticksMax = (int)(seconds * PONG_TICK_RATE);
+    int frames = 0;
+    long long rollbackFrames = 0;
+    double resimTotal = 0.0;
+
+    // real time frames, the injected latency is measured against the wall clock
+    double start = GetSeconds(), settleStart = 0.0;
+    while (true) {
+        bool done = true;
+        for (int i = 0; i < 2; ++i) {
+            NetPlayPoll(&net[i], &state[i]);
+            rollbackFrames += net[i].stats.rollbackTicks > 0;
+            resimTotal += net[i].stats.resimTime;
+
+            for (int tick = 0; tick < PONG_TICK_RATE / FRAME_RATE; ++tick) {
+                if (net[i].tick >= ticksMax) {
+                    break;
+                }
+                buttons[i] = RandomButtons(&rngState[i], buttons[i]);
+                NetPlayAdvance(&net[i], &state[i], buttons[i]);
+            }
+            NetPlaySend(&net[i]);
+
+            done = done && net[i].tick >= ticksMax && NetPlayIsConfirmed(&net[i]);
+        }
+        if (done) {
+            break;
+        }
+
+        if (net[0].tick >= ticksMax && net[1].tick >= ticksMax && settleStart == 0.0) {
+            settleStart = GetSeconds();
+        }
+        if (settleStart > 0.0 && GetSeconds() - settleStart > SETTLE_TIMEOUT) {
+            break;
+        }
+        if (net[0].status == NET_TIMED_OUT || net[1].status == NET_TIMED_OUT) {
+            break;
+        }
+
+        ++frames;
+        SleepUntil(start + (double)frames / FRAME_RATE);
+    }
+    double elapsed = GetSeconds() - start;
+
+    bool match = net[0].tick == net[1].tick &&
+                 memcmp(&state[0], &state[1], sizeof(PongState)) == 0;
+    NetStats *s0 = &net[0].stats, *s1 = &net[1].stats;
+    long long rollbacks = s0->rollbacks + s1->rollbacks;
+    long long resimulated = s0->resimulated + s1->resimulated;
+    int rollbackMax =
+        s0->rollbackMax > s1->rollbackMax ? s0->rollbackMax : s1->rollbackMax;
+    double resimMax = s0->resimMax > s1->resimMax ? s0->resimMax : s1->resimMax;
+
+    printf("ticks:      host %d, peer %d in %.2f s (%d frames)\n", net[0].tick,
+           net[1].tick, elapsed, frames);
+    printf("rollbacks:  %lld, mean depth %.2f, max %d ticks\n", rollbacks,
+           rollbacks > 0 ? (double)resimulated / rollbacks : 0.0, rollbackMax);
+    printf("resim:      mean %.4f ms, max %.4f ms per rolled back frame\n",
+           rollbackFrames > 0 ? 1000.0 * resimTotal / rollbackFrames : 0.0,
+           1000.0 * resimMax);
+    printf("stalls:     host %lld, peer %lld ticks\n", s0->stalls, s1->stalls);
+    printf("packets:    sent %lld, dropped %lld, received %lld\n", s0->sent + s1->sent,
+           s0->dropped + s1->dropped, s0->received + s1->received);
+    printf("score:      %dx%d\n", state[0].leftScore, state[0].rightScore);
+    printf("states:     %s\n", match ? "match" : "DIFFER");
+
+    DestroyNetPlay(&net[0]);
+    DestroyNetPlay(&net[1]);
+    free(net);
+
+    return match ? 0 : 1;
+}
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+void SleepUntil(double time) {
+    double wait = time - GetSeconds();
+    if (wait > 0.0) {
+        struct timespec ts = {.tv_sec = (time_t)wait,
+                              .tv_nsec = (long)((wait - (time_t)wait) * 1e9)};
+        nanosleep(&ts, NULL);
+    }
+}
+
+unsigned int RandomButtons(unsigned int *rngState, unsigned int buttons) {
+    // a player holds a key for a while, roughly a tenth of a second
+    unsigned int x = *rngState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *rngState = x;
+
+    if (x % 24 != 0) {
+        return buttons;
+    }
+    return (x >> 8) % 3 == 0   ? NET_BUTTON_UP
+           : (x >> 8) % 3 == 1 ? NET_BUTTON_DOWN
+                               : 0;
+}
@@ -0,0 +1,336 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "netplay.h"
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "tick.h"
+
+// Packet layout, all integers little endian:
+//   u16 magic, u8 player, u8 count, u32 seed, u32 first tick, u32 ticks received
+//   count input bytes, from the first tick on
+#define NET_MAGIC       0x4e50
+#define NET_HEADER_SIZE 16
+#define NET_INPUTS_MAX  (NET_PACKET_MAX - NET_HEADER_SIZE)
+
+// Seconds without a packet before the peer is given up
+#define NET_TIMEOUT 5.0
+
+// Copies of the last packet sent when closing, so the peer can finish the match
+#define NET_CLOSE_REPEATS 3
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static float RandomFloat(NetPlay *net) {
+    // xorshift32, only drives the loss and latency injection
+    unsigned int x = net->rngState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    net->rngState = x;
+    return (x >> 8) / 16777216.0f;
+}
+
+static void PutU32(unsigned char *bytes, unsigned int value) {
+    for (int i = 0; i < 4; ++i) {
+        bytes[i] = (value >> (8 * i)) & 0xff;
+    }
+}
+
+static unsigned int GetU32(const unsigned char *bytes) {
+    return bytes[0] | bytes[1] << 8 | bytes[2] << 16 | (unsigned int)bytes[3] << 24;
+}
+
+static float ButtonsMove(unsigned char buttons) {
+    return ((buttons & NET_BUTTON_DOWN) ? 1.0f : 0.0f) -
+           ((buttons & NET_BUTTON_UP) ? 1.0f : 0.0f);
+}
+
+static unsigned char PredictRemote(const NetPlay *net, int tick) {
+    // the peer most likely still holds what it held last
+    if (tick <= net->remoteConfirmed) {
+        return net->remoteInput[tick % NET_INPUT_HISTORY];
+    }
+    if (net->remoteConfirmed >= 0) {
+        return net->remoteInput[net->remoteConfirmed % NET_INPUT_HISTORY];
+    }
+    return 0;
+}
+
+static void StepTick(NetPlay *net, PongState *state, int tick) {
+    unsigned char local = net->localInput[tick % NET_INPUT_HISTORY];
+    unsigned char remote = PredictRemote(net, tick);
+    net->usedRemote[tick % NET_INPUT_HISTORY] = remote;
+
+    PongInput input = {.leftMove = ButtonsMove(net->player == 0 ? local : remote),
+                       .rightMove = ButtonsMove(net->player == 0 ? remote : local)};
+    net->snapshots[tick % (NET_ROLLBACK_MAX + 1)] = *state;
+    PongStep(state, input, PONG_TICK_DT);
+}
+
+static void SendNow(NetPlay *net, const unsigned char *data, int size) {
+    sendto(net->socket, data, size, 0, (const struct sockaddr *)&net->peer,
+           sizeof(net->peer));
+    ++net->stats.sent;
+}
+
+static void FlushDelayed(NetPlay *net, double now) {
+    // released in the order they were sent, jitter delays but never reorders
+    while (net->delayedCount > 0 && net->delayed[net->delayedFirst].sendAt <= now) {
+        NetDelayed *packet = &net->delayed[net->delayedFirst];
+        SendNow(net, packet->data, packet->size);
+        net->delayedFirst = (net->delayedFirst + 1) % NET_DELAY_SLOTS;
+        --net->delayedCount;
+    }
+}
+
+static void QueuePacket(NetPlay *net, const unsigned char *data, int size) {
+    if (RandomFloat(net) < net->config.loss) {
+        ++net->stats.dropped;
+        return;
+    }
+
+    if (net->config.latency <= 0.0f && net->config.jitter <= 0.0f) {
+        SendNow(net, data, size);
+        return;
+    }
+    if (net->delayedCount == NET_DELAY_SLOTS) {
+        ++net->stats.dropped;
+        return;
+    }
+
+    float jitter = net->config.jitter * (2.0f * RandomFloat(net) - 1.0f);
+    float delay = net->config.latency + jitter;
+    NetDelayed *packet =
+        &net->delayed[(net->delayedFirst + net->delayedCount++) % NET_DELAY_SLOTS];
+    packet->sendAt = GetSeconds() + (delay > 0.0f ? delay : 0.0f);
+    packet->size = size;
+    memcpy(packet->data, data, size);
+}
+
+static int EncodePacket(const NetPlay *net, unsigned char *bytes) {
+    // every local input the peer hasn't acknowledged, so a lost packet costs nothing
+    // as long as a later one arrives
+    int first = net->localAcked + 1;
+    int last = net->status == NET_RUNNING ? net->tick + net->config.inputDelay - 1 : -1;
+    int count = last - first + 1;
+    count = count < 0 ? 0 : count > NET_INPUTS_MAX ? NET_INPUTS_MAX : count;
+
+    bytes[0] = NET_MAGIC & 0xff;
+    bytes[1] = NET_MAGIC >> 8;
+    bytes[2] = net->player;
+    bytes[3] = count;
+    PutU32(bytes + 4, net->config.seed);
+    PutU32(bytes + 8, first);
+    PutU32(bytes + 12, net->remoteConfirmed + 1);
+    for (int i = 0; i < count; ++i) {
+        bytes[NET_HEADER_SIZE + i] = net->localInput[(first + i) % NET_INPUT_HISTORY];
+    }
+
+    return NET_HEADER_SIZE + count;
+}
+
+static void ReceivePacket(NetPlay *net, PongState *state, const unsigned char *bytes,
+                          int size) {
+    if (size < NET_HEADER_SIZE || (bytes[0] | bytes[1] << 8) != NET_MAGIC ||
+        bytes[2] != 1 - net->player || size != NET_HEADER_SIZE + bytes[3]) {
+        return;
+    }
+    ++net->stats.received;
+    net->lastReceived = GetSeconds();
+
+    // the first packet starts the match, with the host seed on both ends
+    if (net->status == NET_CONNECTING) {
+        if (net->player == 1) {
+            net->config.seed = GetU32(bytes + 4);
+        }
+        PongInit(state, net->config.seed, CONTROL_PLAYER, CONTROL_PLAYER);
+        net->status = NET_RUNNING;
+    }
+
+    int acked = (int)GetU32(bytes + 12) - 1;
+    net->localAcked = acked > net->localAcked ? acked : net->localAcked;
+
+    // inputs are taken in order only, a gap waits for the next packet to resend it
+    int first = GetU32(bytes + 8);
+    for (int i = 0; i < bytes[3]; ++i) {
+        int tick = first + i;
+        if (tick != net->remoteConfirmed + 1) {
+            continue;
+        }
+
+        unsigned char buttons = bytes[NET_HEADER_SIZE + i];
+        net->remoteInput[tick % NET_INPUT_HISTORY] = buttons;
+        ++net->remoteConfirmed;
+
+        // a tick already simulated with another prediction has to run again
+        bool mispredicted =
+            tick < net->tick && buttons != net->usedRemote[tick % NET_INPUT_HISTORY];
+        if (mispredicted && (net->rollbackFrom < 0 || tick < net->rollbackFrom)) {
+            net->rollbackFrom = tick;
+        }
+    }
+}
+
+NetPlay CreateNetPlay(NetConfig config) {
+    NetPlay net = {0};
+    net.config = config;
+    if (net.config.inputDelay < 0 || net.config.inputDelay > NET_DELAY_MAX) {
+        net.config.inputDelay = net.config.inputDelay < 0 ? 0 : NET_DELAY_MAX;
+    }
+    net.player = config.peerHost != NULL ? 1 : 0;
+    net.remoteConfirmed = -1;
+    net.localAcked = -1;
+    net.rollbackFrom = -1;
+    net.rngState = config.seed != 0 ? config.seed : 0x9e3779b9u;
+
+    net.socket = socket(AF_INET, SOCK_DGRAM, 0);
+    if (net.socket < 0) {
+        return net;
+    }
+    fcntl(net.socket, F_SETFL, fcntl(net.socket, F_GETFL, 0) | O_NONBLOCK);
+
+    struct sockaddr_in local = {0};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(config.port);
+    if (bind(net.socket, (struct sockaddr *)&local, sizeof(local)) != 0) {
+        close(net.socket);
+        return net;
+    }
+
+    if (config.peerHost != NULL) {
+        struct addrinfo hints = {0}, *found;
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        char port[8];
+        snprintf(port, sizeof(port), "%d", config.peerPort);
+        if (getaddrinfo(config.peerHost, port, &hints, &found) != 0) {
+            close(net.socket);
+            return net;
+        }
+        memcpy(&net.peer, found->ai_addr, sizeof(net.peer));
+        net.hasPeer = true;
+        freeaddrinfo(found);
+    }
+
+    net.status = NET_CONNECTING;
+    net.lastReceived = GetSeconds();
+
+    return net;
+}
+
+void DestroyNetPlay(NetPlay *net) {
+    if (net->status == NET_CLOSED) {
+        return;
+    }
+
+    // the peer may still miss the last inputs, send them without injected faults
+    if (net->hasPeer) {
+        unsigned char bytes[NET_PACKET_MAX];
+        int size = EncodePacket(net, bytes);
+        for (int i = 0; i < NET_CLOSE_REPEATS; ++i) {
+            SendNow(net, bytes, size);
+        }
+    }
+
+    close(net->socket);
+    net->status = NET_CLOSED;
+}
+
+void NetPlayPoll(NetPlay *net, PongState *state) {
+    if (net->status != NET_CONNECTING && net->status != NET_RUNNING) {
+        return;
+    }
+    double now = GetSeconds();
+    FlushDelayed(net, now);
+
+    unsigned char bytes[NET_PACKET_MAX];
+    struct sockaddr_in from;
+    socklen_t fromSize = sizeof(from);
+    int size;
+    while ((size = recvfrom(net->socket, bytes, sizeof(bytes), 0,
+                            (struct sockaddr *)&from, &fromSize)) >= 0) {
+        // the host takes the first sender as its peer and ignores everybody else
+        if (!net->hasPeer) {
+            net->peer = from;
+            net->hasPeer = true;
+        } else if (from.sin_addr.s_addr != net->peer.sin_addr.s_addr ||
+                   from.sin_port != net->peer.sin_port) {
+            continue;
+        }
+        ReceivePacket(net, state, bytes, size);
+        fromSize = sizeof(from);
+    }
+
+    if (net->status == NET_RUNNING && now - net->lastReceived > NET_TIMEOUT) {
+        net->status = NET_TIMED_OUT;
+        return;
+    }
+
+    // restore the state before the first wrong prediction and catch up again
+    net->stats.rollbackTicks = 0;
+    net->stats.resimTime = 0.0;
+    if (net->rollbackFrom >= 0) {
+        double start = GetSeconds();
+        *state = net->snapshots[net->rollbackFrom % (NET_ROLLBACK_MAX + 1)];
+        for (int tick = net->rollbackFrom; tick < net->tick; ++tick) {
+            StepTick(net, state, tick);
+        }
+        NetStats *stats = &net->stats;
+        stats->rollbackTicks = net->tick - net->rollbackFrom;
+        stats->resimTime = GetSeconds() - start;
+        stats->rollbackMax = stats->rollbackTicks > stats->rollbackMax
+                                 ? stats->rollbackTicks
+                                 : stats->rollbackMax;
+        stats->resimMax =
+            stats->resimTime > stats->resimMax ? stats->resimTime : stats->resimMax;
+        ++stats->rollbacks;
+        stats->resimulated += stats->rollbackTicks;
+        net->rollbackFrom = -1;
+    }
+}
+
+bool NetPlayAdvance(NetPlay *net, PongState *state, unsigned int buttons) {
+    if (net->status != NET_RUNNING) {
+        return false;
+    }
+
+    // wait for the peer when a rollback would go deeper than the snapshots kept, or
+    // the local inputs it hasn't acknowledged wouldn't fit a packet anymore
+    int tick = net->tick;
+    int delay = net->config.inputDelay;
+    if (tick - net->remoteConfirmed > NET_ROLLBACK_MAX ||
+        tick + delay - net->localAcked >= NET_INPUTS_MAX) {
+        ++net->stats.stalls;
+        return false;
+    }
+
+    net->localInput[(tick + delay) % NET_INPUT_HISTORY] = buttons & 0xff;
+    StepTick(net, state, tick);
+    ++net->tick;
+
+    return true;
+}
+
+void NetPlaySend(NetPlay *net) {
+    if ((net->status != NET_CONNECTING && net->status != NET_RUNNING) ||
+        !net->hasPeer) {
+        return;
+    }
+
+    unsigned char bytes[NET_PACKET_MAX];
+    int size = EncodePacket(net, bytes);
+    QueuePacket(net, bytes, size);
+    FlushDelayed(net, GetSeconds());
+}
+
+bool NetPlayIsConfirmed(const NetPlay *net) {
+    return net->remoteConfirmed >= net->tick - 1;
+}
@@ -0,0 +1,100 @@
+#ifndef NETPLAY_H
+#define NETPLAY_H
+
+#include <netinet/in.h>
+#include <stdbool.h>
+
+#include "pong_sim.h"
+
+// Ticks the simulation may run ahead of the last input received from the peer, also
+// the deepest rollback
+#define NET_ROLLBACK_MAX 10
+
+// Input ticks kept for sending and resimulating, a power of two
+#define NET_INPUT_HISTORY 128
+#define NET_DELAY_MAX     16 // ticks
+
+// Outgoing packets held back by the latency injection
+#define NET_DELAY_SLOTS 256
+#define NET_PACKET_MAX  96
+
+// -------------------------------------------------------------------------------------
+// Enumerations
+// -------------------------------------------------------------------------------------
+typedef enum {
+    NET_BUTTON_UP = 1 << 0,
+    NET_BUTTON_DOWN = 1 << 1
+} NetButton;
+
+typedef enum {
+    NET_CLOSED = 0,
+    NET_CONNECTING, // no packet from the peer yet
+    NET_RUNNING,
+    NET_TIMED_OUT // the peer went quiet
+} NetStatus;
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+typedef struct NetConfig {
+    int port;              // local UDP port, 0 for any
+    const char *peerHost;  // NULL to host, the peer is learnt from its first packet
+    int peerPort;          // port of peerHost
+    unsigned int seed;     // match seed, the host's one is used
+    int inputDelay;        // ticks between reading and applying local input
+    float latency, jitter; // seconds added to every packet sent
+    float loss;            // [0.0,1.0] ratio of packets dropped on send
+} NetConfig;
+
+typedef struct NetStats {
+    int rollbackTicks, rollbackMax; // ticks resimulated by the last poll, and worst
+    double resimTime, resimMax;     // seconds spent resimulating by the last poll
+    long long rollbacks, resimulated, stalls;
+    long long sent, dropped, received;
+} NetStats;
+
+typedef struct NetDelayed {
+    double sendAt;
+    int size;
+    unsigned char data[NET_PACKET_MAX];
+} NetDelayed;
+
+// Two player match over UDP with GGPO style rollback. The missing peer input is
+// predicted by repeating its last one, when the real input arrives and differs the
+// match is restored from the snapshot of that tick and simulated again. The host is
+// the left paddle and the peer the right one. Nothing is allocated after creation.
+typedef struct NetPlay {
+    NetStatus status;
+    int player; // 0 left, 1 right
+    NetConfig config;
+    int socket;
+    struct sockaddr_in peer;
+    bool hasPeer;
+    double lastReceived;
+
+    int tick; // ticks simulated, the state is at this tick
+    unsigned char localInput[NET_INPUT_HISTORY];
+    unsigned char remoteInput[NET_INPUT_HISTORY];
+    unsigned char usedRemote[NET_INPUT_HISTORY]; // remote input every tick ran with
+    int remoteConfirmed;                         // last remote tick received, or -1
+    int localAcked;                              // last local tick the peer has
+    int rollbackFrom;                            // first tick to simulate again, or -1
+    PongState snapshots[NET_ROLLBACK_MAX + 1];   // state before every predicted tick
+
+    NetDelayed delayed[NET_DELAY_SLOTS];
+    int delayedFirst, delayedCount;
+    unsigned int rngState; // loss and jitter
+    NetStats stats;
+} NetPlay;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+NetPlay CreateNetPlay(NetConfig config);
+void DestroyNetPlay(NetPlay *net);
+void NetPlayPoll(NetPlay *net, PongState *state);
+bool NetPlayAdvance(NetPlay *net, PongState *state, unsigned int buttons);
+void NetPlaySend(NetPlay *net);
+bool NetPlayIsConfirmed(const NetPlay *net);
+
+#endif // NETPLAY_H
@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset_pack.h"
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+static bool ReadFile(const char *path, unsigned char **data, size_t *size);
+static bool DecodeWav(const unsigned char *data, size_t size, AssetEntry *entry);
+static void AssetName(const char *path, char *name);
+static unsigned int GetU16(const unsigned char *bytes);
+static unsigned int GetU32(const unsigned char *bytes);
+
+// -------------------------------------------------------------------------------------
+// Entrypoint
+// -------------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+    if (argc < 3 || argc - 2 > ASSET_PACK_ENTRIES_MAX) {
+        fprintf(stderr, "usage: %s PACK FILE...\n", argv[0]);
+        fprintf(stderr, "  packs at most %d WAV files, named after the file\n",
+                ASSET_PACK_ENTRIES_MAX);
+        return 1;
+    }
+
+    // every sound decoded here, the games map the samples as they are
+    AssetEntry entries[ASSET_PACK_ENTRIES_MAX] = {0};
+    unsigned char *files[ASSET_PACK_ENTRIES_MAX] = {0};
+    int count = argc - 2;
+    bool valid = true;
+    for (int i = 0; i < count && valid; ++i) {
+        const char *path = argv[i + 2];
+        size_t size = 0;
+        valid = ReadFile(path, &files[i], &size) &&
+                DecodeWav(files[i], size, &entries[i]);
+        if (!valid) {
+            fprintf(stderr, "%s: not a PCM WAV file\n", path);
+            break;
+        }
+        AssetName(path, entries[i].name);
+        for (int j = 0; j < i; ++j) {
+            if (strcmp(entries[i].name, entries[j].name) == 0) {
+                fprintf(stderr, "%s: %s is already packed\n", path, entries[i].name);
+                valid = false;
+            }
+        }
+        printf("%-24s %u Hz, %u bit, %u channels, %u frames\n", entries[i].name,
+               entries[i].wave.sampleRate, entries[i].wave.sampleSize,
+               entries[i].wave.channels, entries[i].wave.frameCount);
+    }
+
+    if (valid && !WriteAssetPack(argv[1], entries, count)) {
+        fprintf(stderr, "%s: failed to write the pack\n", argv[1]);
+        valid = false;
+    }
+    for (int i = 0; i < count; ++i) {
+        free(files[i]);
+    }
+
+    return valid ? 0 : 1;
+}
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static bool ReadFile(const char *path, unsigned char **data, size_t *size) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    *data = length > 0 ? malloc(length) : NULL;
+    bool read = *data != NULL && fread(*data, 1, length, file) == (size_t)length;
+    fclose(file);
+    *size = read ? length : 0;
+    return read;
+}
+
+static bool DecodeWav(const unsigned char *data, size_t size, AssetEntry *entry) {
+    // 8 or 16 bit PCM or 32 bit float, the samples a raylib Wave holds; other chunks
+    // are skipped
+    if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+
+    bool hasFormat = false;
+    for (size_t offset = 12; offset + 8 <= size;) {
+        const unsigned char *chunk = data + offset;
+        size_t chunkSize = GetU32(chunk + 4);
+        if (chunkSize > size - offset - 8) {
+            return false;
+        }
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16) {
+            unsigned int format = GetU16(chunk + 8);
+            entry->wave.channels = GetU16(chunk + 10);
+            entry->wave.sampleRate = GetU32(chunk + 12);
+            entry->wave.sampleSize = GetU16(chunk + 22);
+            hasFormat = (format == 1 && (entry->wave.sampleSize == 8 ||
+                                         entry->wave.sampleSize == 16)) ||
+                        (format == 3 && entry->wave.sampleSize == 32);
+            hasFormat = hasFormat && entry->wave.channels > 0;
+        } else if (memcmp(chunk, "data", 4) == 0 && hasFormat) {
+            unsigned int frameSize =
+                entry->wave.channels * (entry->wave.sampleSize / 8);
+            entry->type = ASSET_SOUND;
+            entry->wave.frameCount = chunkSize / frameSize;
+            entry->wave.data = (void *)(chunk + 8);
+            entry->size = entry->wave.frameCount * frameSize;
+            return true;
+        }
+
+        // chunks are padded to an even size
+        offset += 8 + chunkSize + (chunkSize & 1);
+    }
+    return false;
+}
+
+static void AssetName(const char *path, char *name) {
+    // the file name without its directory or extension
+    const char *start = strrchr(path, '/');
+    start = start != NULL ? start + 1 : path;
+    const char *end = strrchr(start, '.');
+    size_t length = end != NULL ? (size_t)(end - start) : strlen(start);
+    length = length < ASSET_NAME_SIZE - 1 ? length : ASSET_NAME_SIZE - 1;
+    memcpy(name, start, length);
+    name[length] = '\0';
+}
+
+static unsigned int GetU16(const unsigned char *bytes) {
+    return bytes[0] | (unsigned int)bytes[1] << 8;
+}
+
+static unsigned int GetU32(const unsigned char *bytes) {
+    return GetU16(bytes) | GetU16(bytes + 2) << 16;
+}
@@ -0,0 +1,150 @@
+#include "perf_hud.h"
+
+#include <math.h>
+#include <stddef.h>
+
+// Quads the HUD render batch can hold before flushing on its own
+#if defined(PLATFORM_WEB)
+#define PERF_HUD_BATCH_ELEMENTS 16384 // 16 bit indices
+#else
+#define PERF_HUD_BATCH_ELEMENTS 32768
+#endif
+
+#define PERF_HUD_WIDTH    220
+#define PERF_HUD_HEIGHT   110
+#define PERF_HUD_FONTSIZE 10
+
+// Frame budget marked on the histogram
+#define PERF_HUD_TARGET (1.0f / 60.0f)
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+PerfHud CreatePerfHud(void) {
+    PerfHud hud = {0};
+    hud.batch = rlLoadRenderBatch(1, PERF_HUD_BATCH_ELEMENTS);
+    return hud;
+}
+
+void DestroyPerfHud(PerfHud *hud) {
+    // go back to the default batch before releasing ours
+    if (hud->batchActive) {
+        rlSetRenderBatchActive(NULL);
+    }
+    rlUnloadRenderBatch(hud->batch);
+    hud->batchActive = false;
+}
+
+void PerfHudBeginFrame(PerfHud *hud) {
+    // activated here and not on creation, the batch must not move once in use
+    if (!hud->batchActive) {
+        rlSetRenderBatchActive(&hud->batch);
+        hud->batchActive = true;
+    }
+
+    hud->frameStart = GetTime();
+}
+
+void PerfHudMark(PerfHud *hud, PerfMark mark) {
+    hud->marks[mark] = GetTime();
+
+    if (mark == PERF_MARK_RENDER) {
+        // nothing has been flushed yet, the batch holds the whole frame
+        hud->drawCalls = 0;
+        hud->vertices = 0;
+        for (int i = 0; i < hud->batch.drawCounter; ++i) {
+            int vertexCount = hud->batch.draws[i].vertexCount;
+            hud->drawCalls += vertexCount > 0;
+            hud->vertices += vertexCount;
+        }
+    }
+}
+
+void PerfHudEndFrame(PerfHud *hud) {
+    double frameEnd = GetTime();
+
+    hud->samples[hud->head] = (PerfSample){
+        .time = frameEnd,
+        .frame = frameEnd - hud->frameStart,
+        .update = hud->marks[PERF_MARK_UPDATE] - hud->frameStart,
+        .render = hud->marks[PERF_MARK_RENDER] - hud->marks[PERF_MARK_UPDATE],
+        .swap = frameEnd - hud->marks[PERF_MARK_OVERLAY],
+        .overlay = hud->marks[PERF_MARK_OVERLAY] - hud->marks[PERF_MARK_RENDER],
+        .drawCalls = hud->drawCalls,
+        .vertices = hud->vertices};
+
+    hud->head = (hud->head + 1) % PERF_HUD_SAMPLES;
+    if (hud->count < PERF_HUD_SAMPLES) {
+        ++hud->count;
+    }
+}
+
+void RenderPerfHud(const PerfHud *hud, int x, int y) {
+    int histogram[PERF_HUD_BUCKETS] = {0};
+    float update = 0.0f, render = 0.0f, swap = 0.0f, frame = 0.0f, worst = 0.0f;
+    int frames = 0, maxCount = 1;
+
+    if (hud->count == 0) {
+        return;
+    }
+
+    // walk back from the newest frame until the window is covered
+    const PerfSample *last = &hud->samples[(hud->head + PERF_HUD_SAMPLES - 1) %
+                                           PERF_HUD_SAMPLES];
+    for (int i = 1; i <= hud->count; ++i) {
+        const PerfSample *sample =
+            &hud->samples[(hud->head + PERF_HUD_SAMPLES - i) % PERF_HUD_SAMPLES];
+        if (last->time - sample->time > PERF_HUD_WINDOW) {
+            break;
+        }
+
+        int bucket = (int)(sample->frame / PERF_HUD_BUCKET_SIZE);
+        bucket = bucket < PERF_HUD_BUCKETS ? bucket : PERF_HUD_BUCKETS - 1;
+        if (++histogram[bucket] > maxCount) {
+            maxCount = histogram[bucket];
+        }
+
+        update += sample->update;
+        render += sample->render;
+        swap += sample->swap;
+        frame += sample->frame;
+        worst = fmaxf(worst, sample->frame);
+        ++frames;
+    }
+
+    // p99 is the upper edge of the bucket reaching 99% of the frames
+    float p99 = worst;
+    for (int b = 0, seen = 0; b < PERF_HUD_BUCKETS - 1; ++b) {
+        seen += histogram[b];
+        if (seen * 100 >= frames * 99) {
+            p99 = fminf((b + 1) * PERF_HUD_BUCKET_SIZE, worst);
+            break;
+        }
+    }
+
+    DrawRectangle(x, y, PERF_HUD_WIDTH, PERF_HUD_HEIGHT, Fade(BLACK, 0.75f));
+    DrawText(TextFormat("FRAME %5.2f ms  P99 %5.2f  MAX %5.2f",
+                        1000.0f * frame / frames, 1000.0f * p99, 1000.0f * worst),
+             x + 10, y + 8, PERF_HUD_FONTSIZE, GREEN);
+    DrawText(TextFormat("UPDATE %5.2f  RENDER %5.2f  SWAP %5.2f",
+                        1000.0f * update / frames, 1000.0f * render / frames,
+                        1000.0f * swap / frames),
+             x + 10, y + 22, PERF_HUD_FONTSIZE, GREEN);
+    DrawText(TextFormat("DRAWS %d  VERTS %d  HUD %.2f ms", last->drawCalls,
+                        last->vertices, 1000.0f * last->overlay),
+             x + 10, y + 36, PERF_HUD_FONTSIZE, GREEN);
+
+    // frame times over the window, one pixel per bucket
+    int baseY = y + PERF_HUD_HEIGHT - 8;
+    int barsHeight = PERF_HUD_HEIGHT - 60;
+    for (int b = 0; b < PERF_HUD_BUCKETS; ++b) {
+        if (histogram[b] > 0) {
+            int height = 1 + histogram[b] * (barsHeight - 1) / maxCount;
+            Color color = b * PERF_HUD_BUCKET_SIZE < PERF_HUD_TARGET ? GREEN : ORANGE;
+            DrawRectangle(x + 10 + b, baseY - height, 1, height, color);
+        }
+    }
+    int targetX = x + 10 + (int)(PERF_HUD_TARGET / PERF_HUD_BUCKET_SIZE);
+    DrawLine(targetX, baseY - barsHeight, targetX, baseY, Fade(RED, 0.6f));
+    DrawLine(x + 10, baseY, x + 10 + PERF_HUD_BUCKETS, baseY, GRAY);
+}
@@ -0,0 +1,63 @@
+#ifndef PERF_HUD_H
+#define PERF_HUD_H
+
+#include <raylib.h>
+#include <rlgl.h>
+#include <stdbool.h>
+
+// Frames kept in the ring, enough for the whole window up to ~200 fps
+#define PERF_HUD_SAMPLES 1024
+#define PERF_HUD_WINDOW  5.0
+
+// Frame time histogram, 0.25 ms buckets up to 50 ms, longer frames go in the last one
+#define PERF_HUD_BUCKETS     200
+#define PERF_HUD_BUCKET_SIZE 0.00025f
+
+// -------------------------------------------------------------------------------------
+// Enumerations
+// -------------------------------------------------------------------------------------
+// Points of the frame the game loop marks, in this order
+typedef enum {
+    PERF_MARK_UPDATE = 0, // screen updated, before BeginDrawing
+    PERF_MARK_RENDER,     // screen rendered, batch counters are read here
+    PERF_MARK_OVERLAY,    // HUD rendered, right before EndDrawing
+    PERF_MARK_COUNT
+} PerfMark;
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+typedef struct PerfSample {
+    double time;                // when the frame ended
+    float frame;                // whole frame, seconds
+    float update, render, swap; // phases, swap includes the vsync wait
+    float overlay;              // drawing the HUD, not part of the phases above
+    int drawCalls, vertices;    // submitted by the game, without the HUD itself
+} PerfSample;
+
+// Frame timings in a fixed ring, nothing is allocated once created. The HUD installs
+// its own render batch, big enough that a frame is only flushed by EndDrawing, so
+// the draw calls and vertices of the whole frame can be read before it.
+typedef struct PerfHud {
+    PerfSample samples[PERF_HUD_SAMPLES];
+    int head, count;
+
+    double frameStart;
+    double marks[PERF_MARK_COUNT];
+    int drawCalls, vertices;
+
+    rlRenderBatch batch;
+    bool batchActive;
+} PerfHud;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+PerfHud CreatePerfHud(void);
+void DestroyPerfHud(PerfHud *hud);
+void PerfHudBeginFrame(PerfHud *hud);
+void PerfHudMark(PerfHud *hud, PerfMark mark);
+void PerfHudEndFrame(PerfHud *hud);
+void RenderPerfHud(const PerfHud *hud, int x, int y);
+
+#endif // PERF_HUD_H
@@ -1,49 +1,61 @@
 #include <math.h>
 #include <raylib.h>
 #include <raymath.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "asset_pack.h"
+#include "audio_mixer.h"
+#include "ball_pool.h"
+#include "brick_grid.h"
+#include "golden.h"
+#include "input_sampler.h"
+#include "netplay.h"
+#include "draw_list.h"
+#include "pong_sim.h"
+#include "replay.h"
+#include "runtime.h"
+#include "tick.h"
+#include "trace.h"
+#include "video.h"
 
-#if defined(PLATFORM_WEB)
-#include <emscripten/emscripten.h>
-#endif
+// Screen constants
+#define SCREEN_TITLE "Pong"
 
-#ifndef ASSET_PATH
-#define ASSET_PATH "./assets"
-#endif 
+// Ticks simulated at most per frame, longer hitches are dropped
+#define TICK_CATCHUP_MAX 16
 
-// Screen constants
-#define SCREEN_TITLE     "Pong"
-#define SCREEN_WIDTH     800
-#define SCREEN_HEIGHT    600
-#define SCREEN_FADE_TIME 0.3f
+// Ticks run every frame by fast replay playback
+#define REPLAY_FAST_TICKS (PONG_TICK_RATE * 10)
+
+// Golden images, every screen rendered on the CPU from the same scripted match
+#define GOLDEN_SEED       1
+#define GOLDEN_TICKS      (PONG_TICK_RATE * 3)
+#define GOLDEN_FADES      5
+#define GOLDEN_BENCH_TIME 0.25
+
+// Video export, frames per second of the stream and the longest match it holds
+#define EXPORT_FPS         60
+#define EXPORT_SECONDS_MAX 300
+
+// Sounds, the pool balls hitting a paddle in one tick heard at most
+#define POOL_HIT_SOUNDS_MAX 4
+#define POOL_HIT_GAIN       0.35f
+
+// Replay mode field, the game mode and above it the difficulty plus one. Zero was
+// recorded before the difficulty menu, by the hard IA.
+#define REPLAY_DIFFICULTY_SHIFT 8
+
+// Multi ball mode
+#define MULTI_BALL_START 2000
+#define MULTI_BALL_STEP  1000
 
 // Colors
 #define COLOR_BG BLACK
 #define COLOR_FG WHITE
 
-// Dimensions
-#define PADDLE_WIDTH      15
-#define PADDLE_HEIGHT     80
-#define PADDLE_SPEED      600
-#define PADDLE_IA_SPEED   400
-#define PADDLE_HOR_OFFSET 30
-
-// Ball constants
-#define BALL_WIDTH           15
-#define BALL_HEIGHT          15
-#define BALL_INITIAL_SPEED   400
-#define BALL_SPEED_INCREMENT 100
-
-// Limits for paddles and ball
-#define BORDER_WIDTH 15
-#define LIMIT_TOP    BORDER_WIDTH
-#define LIMIT_RIGHT  (SCREEN_WIDTH - PADDLE_HOR_OFFSET)
-#define LIMIT_BOTTOM (SCREEN_HEIGHT - BORDER_WIDTH)
-#define LIMIT_LEFT   PADDLE_HOR_OFFSET
-
-// How many bouncing points can predict
-#define BOUNCE_POINTS_MAX 20
-
 // -------------------------------------------------------------------------------------
 // Enumerations
 // -------------------------------------------------------------------------------------
@@ -58,9 +70,18 @@ typedef enum {
 typedef enum {
     MENU_ONE_PLAYER = 0,
     MENU_TWO_PLAYERS,
+    MENU_MULTI_BALL,
+    MENU_BRICK_ARENA,
     MENU_COUNT
 } MenuOption;
 
+typedef enum {
+    MODE_CLASSIC = 0,
+    MODE_MULTI_BALL,
+    MODE_BRICK_ARENA,
+    MODE_TWO_PLAYERS
+} GameMode;
+
 typedef enum {
     MENU_SP_EASY = 0,
     MENU_SP_MEDIUM,
@@ -75,103 +96,219 @@ typedef enum {
     MENU_GO_COUNT
 } MenuGameOver;
 
+// Player input for one tick, the unit stored by replays
+typedef enum {
+    BUTTON_UP = 1 << 0,
+    BUTTON_DOWN = 1 << 1,
+    BUTTON_SPAWN = 1 << 2, // extra balls, only set on the tick that spawns them
+    BUTTON_LEFT_UP = 1 << 3,
+    BUTTON_LEFT_DOWN = 1 << 4
+} InputButton;
+
 // -------------------------------------------------------------------------------------
 // Structs
 // -------------------------------------------------------------------------------------
-typedef struct Screen {
-    void (*init)(void);
-    void (*update)(float dt);
-    void (*render)(void);
-    bool hasFinished;
-} Screen;
-
-typedef struct Entity {
-    Rectangle rect; // position and dimensions
-    Vector2 dir;    // normilized direction
-    float speed;    // velocity multiplier
-} Entity;
-
-typedef struct CollisionData {
-    bool hit;              // true if collision has happened
-    float time;            // time for collision [0.0,1.0]
-    Vector2 contactPoint;  // collision point for restitution
-    Vector2 contactNormal; // surface normal where collide
-} CollisionData;
+typedef struct GoldenScreen {
+    const char *name;
+    ScreenState screen;
+    GameMode mode;
+    bool debug;
+} GoldenScreen;
 
 // -------------------------------------------------------------------------------------
 // Globals
 // -------------------------------------------------------------------------------------
 // Screens
-static Screen screens[SCREEN_COUNT];
-static ScreenState currentScreen, nextScreen;
-static float screenFade;
+static DrawList drawList; // render callbacks append to it, submitted once sorted
 
-// Assets
-static Sound soundBeep;
+// Assets, hits play a synthesized beep until the pack has loaded
+static AssetPack assetPack;
+static AudioMixer mixer;
+static int clipBeep, clipBrick;
+static bool soundsLoaded, audioLatencyMode;
 
 // Menu screens
 static MenuOption menuOption;
 static MenuSPOption menuSPOption;
+static bool menuSPOpen; // one player difficulty, in place of the main options
 static MenuGameOver menuGOverOption;
 static float menuBlinkTimer;
 
 // Main game screen
 static bool debugMode;
-static int leftScore, rightScore;
-static Entity leftPaddle, rightPaddle, ball;
-static int hitCounter;
-static Vector2 bouncePoints[BOUNCE_POINTS_MAX];
-static int bouncePointsCount;
-static float iaTargetPos, iaHitPos, iaResponseTime, iaTimer;
-static Vector2 topSP, rightSP, bottomSP, leftSP;
-static Vector2 topEP, rightEP, bottomEP, leftEP;
+static PongState game, previousGame;
+static TickClock gameClock;
+static float gameAlpha;
+static GameMode gameMode;
+static IADifficulty iaDifficulty = IA_HARD;
+static BallPool ballPool;
+static BrickGrid brickGrid;
+static bool spawnRequested; // ball spawn key waiting for the next tick
+static int poolHits;        // pool balls that hit a paddle on the last tick
+
+// Replay
+static Replay replay;
+static const char *recordPath; // every match overwrites it, the last one is kept
+static bool replayFast;
+#if !defined(ARCADE)
+static bool replayRender = true;
+#endif
+static double replayStart;
+
+// Netplay, two players over UDP when started with --host or --join
+static NetConfig netConfig;
+static bool netEnabled;
+static NetPlay netPlay;
+
+// Input, keys come timestamped from the sampler thread or from the frame polling
+static InputSampler inputSampler;
+static bool inputLatencyMode, inputThread = true;
+static double inputPollTime; // when raylib last polled the keys
 
 // -------------------------------------------------------------------------------------
 // Module declaration
 // -------------------------------------------------------------------------------------
-// Screen management
-void InitScreen(ScreenState initialScreen);
-void SetNextScreen(ScreenState state);
-bool ScreenShouldClose(void);
-void UpdateScreen(void);
+// Screen management, the window and the fades are the runtime's
+static Screen CreateScreen(int screenState);
 
 // Menu screen
-void InitMenuScreen(void);
-void UpdateMenuScreen(float dt);
-void RenderMenuScreen(void);
+static void InitMenuScreen(void);
+static void UpdateMenuScreen(float dt);
+static void UpdateMenuSPOptions(void);
+static void RenderMenuScreen(float fading);
 
 // Game screen
-void InitGameScreen(void);
-void UpdateGameScreen(float dt);
-void RenderGameScreen(void);
+static void InitGameScreen(void);
+static void UpdateGameScreen(float dt);
+static void RenderGameScreen(float fading);
 
 // Game over screen
-void InitGameOverScreen(void);
-void UpdateGameOverScreen(float dt);
-void RenderGameOverScreen(void);
+static void InitGameOverScreen(void);
+static void UpdateGameOverScreen(float dt);
+static void RenderGameOverScreen(float fading);
+
+// Match, shared by the game screen and windowless playback
+static void StartGame(unsigned int seed, PaddleControl rightControl);
+static void StepGame(unsigned int buttons);
+static void UpdateNetGame(float dt);
+static void EndGame(ScreenState screen);
+static void ReportReplay(double elapsed);
+
+#if !defined(ARCADE)
+// Replay playback, windowless
+static int RunReplay(void);
+
+// Golden images, windowless
+static int RunGolden(const char *path, bool update);
+static void SetupGolden(const GoldenScreen *golden);
+static void RenderGolden(const GoldenScreen *golden, Raster *raster, float fading);
+
+// Video export, windowless
+static int RunExport(const char *path, VideoFormat format);
+#endif
 
 // Helper functions
-void InitAssets(void);
-void DestroyAssets(void);
-void ResetBall(void);
-float KeyboardInput(void);
-void RenderMenuOptions(const char **options, int numOptions, int currentOption,
-                       Color fadeColor);
-
-// Collision detection
-bool ResolveCollBallPaddle(Entity paddle, Vector2 ballVel);
-void CalculateBouncePoints(void);
-bool RayIntersectLine(Vector2 rayOrigin, Vector2 rayDir, Vector2 lineStart,
-                      Vector2 lineEnd, Vector2 *collPoint, float *collTime);
-float Vector2CrossProduct(Vector2 v1, Vector2 v2);
-bool AABBCheck(Rectangle rect1, Rectangle rect2);
-Rectangle SweptRectangle(Rectangle rect, Vector2 vel);
-CollisionData SweptAABB(Rectangle rect, Vector2 vel, Rectangle target);
+static void InitAssets(void);
+static void DestroyAssets(void);
+static void PollAssets(void);
+static void PlayTickSounds(void);
+static void PlayHitSound(Rectangle ball, float speed, float gain);
+static void MarkInputPoll(void);
+static bool UsesBallPool(void);
+static unsigned int KeyboardKeys(void);
+static unsigned int KeysButtons(unsigned int keys);
+static Rectangle LerpRect(Rectangle from, Rectangle to, float amount);
+static void RenderMenuOptions(const char **options, int numOptions,
+                              int currentOption, Color fadeColor);
+
+// -------------------------------------------------------------------------------------
+// Game module, also linked into the launcher
+// -------------------------------------------------------------------------------------
+const Game pongGame = {.name = SCREEN_TITLE,
+                       .width = SCREEN_WIDTH,
+                       .height = SCREEN_HEIGHT,
+                       .createScreen = &CreateScreen,
+                       .firstScreen = SCREEN_MENU,
+                       .loadAssets = &InitAssets,
+                       .unloadAssets = &DestroyAssets,
+                       .pollAssets = &PollAssets,
+                       .endFrame = &MarkInputPoll,
+                       .drawList = &drawList,
+                       .debugMode = &debugMode};
 
 // -------------------------------------------------------------------------------------
 // Entrypoint
 // -------------------------------------------------------------------------------------
-int main(void) {
+#if !defined(ARCADE)
+int main(int argc, char **argv) {
+    const char *playPath = NULL, *tracePath = NULL, *goldenPath = NULL;
+    const char *exportPath = NULL;
+    bool validArgs = true, goldenUpdate = false, exportPpm = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--play") == 0 && i + 1 < argc) {
+            playPath = argv[++i];
+        } else if (strcmp(argv[i], "--fast") == 0) {
+            replayFast = true;
+        } else if (strcmp(argv[i], "--no-render") == 0) {
+            replayRender = false;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc) {
+            goldenPath = argv[++i];
+        } else if (strcmp(argv[i], "--update") == 0) {
+            goldenUpdate = true;
+        } else if (strcmp(argv[i], "--export") == 0 && i + 1 < argc) {
+            exportPath = argv[++i];
+        } else if (strcmp(argv[i], "--ppm") == 0) {
+            exportPpm = true;
+        } else if (strcmp(argv[i], "--input-latency") == 0) {
+            inputLatencyMode = true;
+        } else if (strcmp(argv[i], "--audio-latency") == 0) {
+            audioLatencyMode = true;
+        } else if (strcmp(argv[i], "--no-input-thread") == 0) {
+            inputThread = false;
+        } else if (strcmp(argv[i], "--host") == 0 && i + 1 < argc) {
+            netConfig.port = atoi(argv[++i]);
+            netEnabled = true;
+        } else if (strcmp(argv[i], "--join") == 0 && i + 1 < argc) {
+            // HOST:PORT, the host part is cut in place
+            char *port = strrchr(argv[++i], ':');
+            validArgs = validArgs && port != NULL;
+            if (port != NULL) {
+                *port = '\0';
+                netConfig.peerHost = argv[i];
+                netConfig.peerPort = atoi(port + 1);
+                netEnabled = true;
+            }
+        } else if (strcmp(argv[i], "--delay") == 0 && i + 1 < argc) {
+            netConfig.inputDelay = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--latency") == 0 && i + 1 < argc) {
+            netConfig.latency = strtof(argv[++i], NULL) / 1000.0f;
+        } else if (strcmp(argv[i], "--jitter") == 0 && i + 1 < argc) {
+            netConfig.jitter = strtof(argv[++i], NULL) / 1000.0f;
+        } else if (strcmp(argv[i], "--loss") == 0 && i + 1 < argc) {
+            netConfig.loss = strtof(argv[++i], NULL) / 100.0f;
+        } else {
+            validArgs = false;
+        }
+    }
+    if (!validArgs || ((replayFast || !replayRender) && playPath == NULL) ||
+        (netEnabled && playPath != NULL) || (goldenUpdate && goldenPath == NULL) ||
+        (exportPpm && exportPath == NULL) ||
+        (exportPath != NULL && (netEnabled || replayFast || !replayRender))) {
+        fprintf(stderr,
+                "usage: %s [--record FILE] [--play FILE [--fast] [--no-render]]\n"
+                "          [--host PORT | --join HOST:PORT] [--delay TICKS]\n"
+                "          [--latency MS] [--jitter MS] [--loss PERCENT]\n"
+                "          [--input-latency] [--no-input-thread] [--audio-latency]\n"
+                "          [--trace FILE]\n"
+                "          [--golden FILE [--update]] [--export FILE|- [--ppm]]\n",
+                argv[0]);
+        return 1;
+    }
 
 // pre configuration
 #if defined(DEBUG)
@@ -180,144 +317,121 @@ int main(void) {
     SetTraceLogLevel(LOG_NONE);
 #endif
 
-    // initialization
-    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_TITLE);
-    InitScreen(SCREEN_MENU);
-    InitAudioDevice();
-    InitAssets();
+    // golden images are checked without a window or a GL context
+    if (goldenPath != NULL) {
+        return RunGolden(goldenPath, goldenUpdate);
+    }
 
-#if defined(PLATFORM_WEB)
-    emscripten_set_main_loop(UpdateScreen, 0, 1);
-#else
-    // pos configuration, must happen after window creation
-    SetTargetFPS(60);
-    SetExitKey(KEY_NULL);
+    // a replay starts straight into its match, without a window if not rendered
+    if (playPath != NULL) {
+        replay = CreateReplayPlayer(playPath);
+        if (replay.mode != REPLAY_PLAY || replay.header.game != REPLAY_GAME_PONG) {
+            fprintf(stderr, "%s: not a pong replay\n", playPath);
+            return 1;
+        }
+        if (!ReplayMatchesBuild(&replay)) {
+            TraceLog(LOG_WARNING, "Replay recorded by build %s, it may not match",
+                     replay.header.build);
+        }
+        unsigned int difficulty = replay.header.mode >> REPLAY_DIFFICULTY_SHIFT;
+        gameMode = replay.header.mode & ((1u << REPLAY_DIFFICULTY_SHIFT) - 1);
+        iaDifficulty = difficulty > 0 ? difficulty - 1 : IA_HARD;
+        if (!replayRender) {
+            return RunReplay();
+        }
+    }
 
-    // gameloop
-    while (!WindowShouldClose() && !ScreenShouldClose()) {
-        UpdateScreen();
+    // the replay, or a match of the IA against itself, rendered to a video stream
+    if (exportPath != NULL) {
+        return RunExport(exportPath, exportPpm ? VIDEO_PPM : VIDEO_Y4M);
     }
-#endif
 
-    // cleanup
-    DestroyAssets();
-    CloseAudioDevice();
-    CloseWindow();
+    // profiling zones, written when the game exits
+    if (tracePath != NULL && !InitTrace(tracePath)) {
+        fprintf(stderr, "built without TRACE=1, no zones to write to %s\n", tracePath);
+    }
+    TRACE_THREAD("main");
+
+    // window, assets and screens, until the last screen closes
+    if (netEnabled) {
+        gameMode = MODE_TWO_PLAYERS;
+    }
+    RunGame(&pongGame, playPath != NULL || netEnabled ? SCREEN_GAME : SCREEN_MENU,
+            replayFast ? 0 : 60);
+    if (tracePath != NULL && CloseTrace()) {
+        printf("trace written to %s\n", tracePath);
+    }
 
     return 0;
 }
+#endif
 
 // -------------------------------------------------------------------------------------
 // Module implementation
 // -------------------------------------------------------------------------------------
-Screen CreateScreen(ScreenState screenState) {
+static Screen CreateScreen(int screenState) {
     Screen screen;
-    screen.hasFinished = false;
 
     switch (screenState) {
     case SCREEN_MENU:
         screen.init = &InitMenuScreen;
         screen.update = &UpdateMenuScreen;
         screen.render = &RenderMenuScreen;
+        screen.updateZone = "UpdateMenuScreen";
+        screen.renderZone = "RenderMenuScreen";
         break;
     case SCREEN_GAME:
         screen.init = &InitGameScreen;
         screen.update = &UpdateGameScreen;
         screen.render = &RenderGameScreen;
+        screen.updateZone = "UpdateGameScreen";
+        screen.renderZone = "RenderGameScreen";
         break;
     case SCREEN_GAME_OVER:
         screen.init = &InitGameOverScreen;
         screen.update = &UpdateGameOverScreen;
         screen.render = &RenderGameOverScreen;
+        screen.updateZone = "UpdateGameOverScreen";
+        screen.renderZone = "RenderGameOverScreen";
         break;
     default:
         screen.init = NULL;
         screen.update = NULL;
         screen.render = NULL;
+        screen.updateZone = NULL;
+        screen.renderZone = NULL;
     }
 
     return screen;
 }
 
-void InitScreen(ScreenState initialScreen) {
-    // create screens
-    for (int i = 0; i < SCREEN_COUNT; ++i) {
-        screens[i] = CreateScreen(i);
-    }
-
-    // set initial screen
-    currentScreen = initialScreen;
-    nextScreen = SCREEN_NONE;
-    screens[currentScreen].init();
-    screenFade = 0.0f;
-}
-
-void SetNextScreen(ScreenState screen) {
-    screens[currentScreen].hasFinished = true;
-    nextScreen = screen;
-}
-
-bool ScreenShouldClose(void) {
-    return screens[currentScreen].hasFinished && nextScreen == SCREEN_NONE;
-}
-
-void UpdateScreen(void) {
-    static bool isFadingIn = true;
-    static bool isFadingOut = false;
-    static float fadingDir = 1.0f;
-
-    float dt = GetFrameTime();
-
-    // update screen
-    if (!isFadingIn && !isFadingOut) {
-        screens[currentScreen].update(dt);
-    } else {
-        screenFade += dt * fadingDir;
-    }
-
-    // render game
-    BeginDrawing();
-    ClearBackground(BLACK);
-    screens[currentScreen].render();
-    EndDrawing();
-
-    if (screens[currentScreen].hasFinished) {
-        isFadingOut = true;
-    }
-
-    if (isFadingIn && fabsf(screenFade) > SCREEN_FADE_TIME) {
-        isFadingIn = false;
-        screenFade = SCREEN_FADE_TIME;
-        fadingDir = -1.0f;
-    }
-
-    if (isFadingOut && fabsf(screenFade) > SCREEN_FADE_TIME) {
-        // reset previous
-        screens[currentScreen].hasFinished = false;
-        isFadingOut = false;
-        isFadingIn = true;
-        screenFade = 0.0f;
-        fadingDir = 1.0f;
-
-        // start new
-        currentScreen = nextScreen;
-        nextScreen = SCREEN_NONE;
-        screens[currentScreen].init();
-    }
-}
-
-void InitMenuScreen(void) {
+static void InitMenuScreen(void) {
     menuOption = MENU_ONE_PLAYER;
     menuSPOption = MENU_SP_EASY;
+    menuSPOpen = false;
     menuBlinkTimer = 0.0f;
     TraceLog(LOG_DEBUG, "Init menu screen");
 }
 
-void UpdateMenuScreen(float dt) {
+static void UpdateMenuScreen(float dt) {
+    menuBlinkTimer += dt;
+    if (menuSPOpen) {
+        UpdateMenuSPOptions();
+        return;
+    }
+
     if (IsKeyPressed(KEY_ESCAPE)) {
         SetNextScreen(SCREEN_NONE);
     }
+    if (IsKeyPressed(KEY_ENTER) && menuOption == MENU_ONE_PLAYER) {
+        menuSPOpen = true;
+        return;
+    }
     if (IsKeyPressed(KEY_ENTER)) {
+        gameMode = menuOption == MENU_TWO_PLAYERS   ? MODE_TWO_PLAYERS
+                   : menuOption == MENU_MULTI_BALL  ? MODE_MULTI_BALL
+                   : menuOption == MENU_BRICK_ARENA ? MODE_BRICK_ARENA
+                                                    : MODE_CLASSIC;
         SetNextScreen(SCREEN_GAME);
     }
     if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_W)) {
@@ -326,215 +440,267 @@ void UpdateMenuScreen(float dt) {
     if (IsKeyPressed(KEY_DOWN) || IsKeyPressed(KEY_S)) {
         menuOption = (menuOption == MENU_COUNT - 1) ? 0 : menuOption + 1;
     }
+}
 
-    menuBlinkTimer += dt;
+static void UpdateMenuSPOptions(void) {
+    // the difficulty also stays for the multi ball and brick arena IA
+    if (IsKeyPressed(KEY_ESCAPE) ||
+        (IsKeyPressed(KEY_ENTER) && menuSPOption == MENU_SP_BACK)) {
+        menuSPOpen = false;
+        return;
+    }
+    if (IsKeyPressed(KEY_ENTER)) {
+        iaDifficulty = menuSPOption == MENU_SP_EASY     ? IA_EASY
+                       : menuSPOption == MENU_SP_MEDIUM ? IA_MEDIUM
+                                                        : IA_HARD;
+        gameMode = MODE_CLASSIC;
+        SetNextScreen(SCREEN_GAME);
+    }
+    if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_W)) {
+        menuSPOption = (menuSPOption == 0) ? MENU_SP_COUNT - 1 : menuSPOption - 1;
+    }
+    if (IsKeyPressed(KEY_DOWN) || IsKeyPressed(KEY_S)) {
+        menuSPOption = (menuSPOption == MENU_SP_COUNT - 1) ? 0 : menuSPOption + 1;
+    }
 }
 
-void RenderMenuScreen(void) {
-    Color fadeColor = Fade(COLOR_FG, screenFade / SCREEN_FADE_TIME);
+static void RenderMenuScreen(float fading) {
+    Color fadeColor = Fade(COLOR_FG, fading);
 
-    int titleMeasure = MeasureText("PONG", 150);
-    DrawText("PONG", (SCREEN_WIDTH - titleMeasure) / 2.0f, 150, 150, fadeColor);
+    int titleMeasure = DrawListMeasureText(&drawList, "PONG", 150);
+    DrawListText(&drawList, "PONG", (SCREEN_WIDTH - titleMeasure) / 2.0f, 150, 150,
+                 fadeColor);
 
-    const char *options[] = {"ONE PLAYER", "TWO PLAYERS"};
-    RenderMenuOptions(options, sizeof(options) / sizeof(const char *), menuOption, fadeColor);
+    if (menuSPOpen) {
+        const char *options[] = {"EASY", "MEDIUM", "HARD", "BACK"};
+        RenderMenuOptions(options, MENU_SP_COUNT, menuSPOption, fadeColor);
+        return;
+    }
+    const char *options[] = {"ONE PLAYER", "TWO PLAYERS", "MULTI BALL",
+                             "BRICK ARENA"};
+    RenderMenuOptions(options, MENU_COUNT, menuOption, fadeColor);
 }
 
-void InitGameScreen(void) {
+static void InitGameScreen(void) {
     debugMode = false;
-    leftScore = 0;
-    rightScore = 0;
-
-    // initialize globals
-    leftPaddle = (Entity){.rect = (Rectangle){0, 0, PADDLE_WIDTH, PADDLE_HEIGHT},
-                          .dir = (Vector2){0},
-                          .speed = PADDLE_IA_SPEED};
-    rightPaddle = leftPaddle;
-    ball = (Entity){.rect = (Rectangle){0, 0, BALL_WIDTH, BALL_HEIGHT},
-                    .dir = (Vector2){0},
-                    .speed = BALL_INITIAL_SPEED};
-
-    // reset paddle positions
-    leftPaddle.rect.x = PADDLE_HOR_OFFSET;
-    leftPaddle.rect.y = (SCREEN_HEIGHT - leftPaddle.rect.height) / 2.0f;
-    rightPaddle.rect.x = SCREEN_WIDTH - PADDLE_HOR_OFFSET - rightPaddle.rect.width;
-    rightPaddle.rect.y = leftPaddle.rect.y;
-    rightPaddle.speed = PADDLE_SPEED;
-
-    // IA
-    topSP = (Vector2){LIMIT_LEFT + PADDLE_WIDTH, LIMIT_TOP};
-    topEP = (Vector2){LIMIT_RIGHT - PADDLE_WIDTH - BALL_WIDTH, LIMIT_TOP};
-    rightSP = (Vector2){LIMIT_RIGHT - PADDLE_WIDTH - BALL_WIDTH, LIMIT_TOP};
-    rightEP =
-        (Vector2){LIMIT_RIGHT - PADDLE_WIDTH - BALL_WIDTH, LIMIT_BOTTOM - BALL_HEIGHT};
-    bottomSP = (Vector2){LIMIT_LEFT + PADDLE_WIDTH, LIMIT_BOTTOM - BALL_HEIGHT};
-    bottomEP =
-        (Vector2){LIMIT_RIGHT - PADDLE_WIDTH - BALL_WIDTH, LIMIT_BOTTOM - BALL_HEIGHT};
-    leftSP = (Vector2){LIMIT_LEFT + PADDLE_WIDTH, LIMIT_TOP};
-    leftEP = (Vector2){LIMIT_LEFT + PADDLE_WIDTH, LIMIT_BOTTOM};
-
-    iaTargetPos = leftPaddle.rect.y;
-    iaHitPos = PADDLE_HEIGHT / 2.0f;
-    iaResponseTime = 0.5f;
-    iaTimer = 0.0f;
-
-    ResetBall();
-}
-
-void UpdateGameScreen(float dt) {
+    spawnRequested = false;
+    InputSamplerFlush(&inputSampler);
+
+    // playback brings its own seed, recording starts a new file for every match.
+    // Netplay isn't recorded, the match starts once the peer answers.
+    unsigned int seed = (unsigned int)time(NULL);
+    if (replay.mode == REPLAY_PLAY) {
+        seed = replay.header.seed;
+        replayStart = GetTime();
+    } else if (gameMode == MODE_TWO_PLAYERS && netEnabled) {
+        netConfig.seed = seed;
+        netPlay = CreateNetPlay(netConfig);
+        if (netPlay.status == NET_CLOSED) {
+            TraceLog(LOG_WARNING, "Can't open the netplay socket");
+        }
+    } else if (recordPath != NULL) {
+        DestroyReplay(&replay);
+        unsigned int mode = gameMode | (iaDifficulty + 1) << REPLAY_DIFFICULTY_SHIFT;
+        replay = CreateReplayRecorder(recordPath, REPLAY_GAME_PONG, seed, mode);
+        if (replay.mode != REPLAY_RECORD) {
+            TraceLog(LOG_WARNING, "Can't record the match to %s", recordPath);
+        }
+    }
+
+    StartGame(seed, CONTROL_PLAYER);
+    previousGame = game;
+    gameClock = CreateTickClock(replayFast ? REPLAY_FAST_TICKS : TICK_CATCHUP_MAX);
+    gameAlpha = 0.0f;
+
+    TraceLog(LOG_DEBUG, "Init game screen");
+}
+
+static void UpdateGameScreen(float dt) {
     if (IsKeyPressed(KEY_ESCAPE)) {
-        SetNextScreen(SCREEN_MENU);
+        EndGame(SCREEN_MENU);
+        return;
     }
     if (IsKeyPressed(KEY_D)) {
         debugMode = !debugMode;
     }
-
-    // get input
-    float input = KeyboardInput();
-    rightPaddle.dir.y = input;
-
-    // update paddles
-    rightPaddle.rect.y += rightPaddle.dir.y * rightPaddle.speed * dt;
-
-    // ia paddle
-    iaTimer += dt;
-    float leftPaddleY = leftPaddle.rect.y + iaHitPos;
-    float leftPaddlePosDiff = (iaTargetPos - leftPaddleY > 0.0f) ? 1.0f : -1.0f;
-    float leftPaddleFuturePos = leftPaddle.speed * dt;
-
-    if (iaTimer > iaResponseTime) {
-        if (leftPaddlePosDiff > 0.0f &&
-            leftPaddleY + leftPaddleFuturePos > iaTargetPos) {
-            leftPaddle.rect.y = iaTargetPos - iaHitPos;
-        } else if (leftPaddlePosDiff < 0.0f &&
-                   leftPaddleY - leftPaddleFuturePos < iaTargetPos) {
-            leftPaddle.rect.y = iaTargetPos - iaHitPos;
-        } else {
-            leftPaddle.rect.y += leftPaddlePosDiff * leftPaddleFuturePos;
-        }
+    if (netPlay.status != NET_CLOSED) {
+        UpdateNetGame(dt);
+        return;
     }
-
-    // keep paddles on screen
-    if (rightPaddle.rect.y < LIMIT_TOP) {
-        rightPaddle.rect.y = LIMIT_TOP;
-    } else if (rightPaddle.rect.y + rightPaddle.rect.height > LIMIT_BOTTOM) {
-        rightPaddle.rect.y = LIMIT_BOTTOM - rightPaddle.rect.height;
+    if (UsesBallPool() && IsKeyPressed(KEY_B)) {
+        spawnRequested = true;
     }
-    if (leftPaddle.rect.y < LIMIT_TOP) {
-        leftPaddle.rect.y = LIMIT_TOP;
-    } else if (leftPaddle.rect.y + leftPaddle.rect.height > LIMIT_BOTTOM) {
-        leftPaddle.rect.y = LIMIT_BOTTOM - leftPaddle.rect.height;
+
+    // get input. Without the sampler thread the keys polled at the end of the last
+    // frame go through its queue, stamped with that time. The evdev keyboards are
+    // read whatever window has the focus, so their keys are dropped without it.
+    double now = GetSeconds();
+    if (!inputSampler.running) {
+        InputSamplerPush(&inputSampler, KeyboardKeys(), inputPollTime);
+    } else if (!IsWindowFocused()) {
+        InputSamplerFlush(&inputSampler);
+        inputSampler.keys = 0;
     }
 
-    // update ball
-    Vector2 ballVel = Vector2Scale(ball.dir, ball.speed * dt);
-    bool hitLeftPaddle, hitRightPaddle;
+    // run the simulation at a fixed rate, whatever the frame time is. Fast playback
+    // banks a large batch of ticks every frame instead.
+    TickClockAdvance(&gameClock, replayFast ? REPLAY_FAST_TICKS * PONG_TICK_DT : dt);
 
-    hitLeftPaddle = ResolveCollBallPaddle(leftPaddle, ballVel);
-    hitRightPaddle = ResolveCollBallPaddle(rightPaddle, ballVel);
+    // the banked time ends now, each tick takes the key changes up to its own end
+    double tickEnd = now - gameClock.accumulator;
+    while (TickClockConsume(&gameClock, PONG_TICK_DT)) {
+        tickEnd += PONG_TICK_DT;
 
-    if (!hitLeftPaddle && !hitRightPaddle) {
-        ball.rect.x += ballVel.x;
-        ball.rect.y += ballVel.y;
-    } else {
-        CalculateBouncePoints();
-        if (hitRightPaddle) {
-            iaTargetPos = bouncePoints[bouncePointsCount].y;
-            iaHitPos = GetRandomValue(0, 1000) / 1000.0f * PADDLE_HEIGHT;
+        // playback takes the recorded buttons, the live ones are recorded if asked
+        unsigned int tickButtons = 0;
+        if (replay.mode == REPLAY_PLAY) {
+            if (!ReplayReadTick(&replay, &tickButtons)) {
+                EndGame(SCREEN_NONE);
+                break;
+            }
         } else {
-            // ia hit the ball
-            iaTargetPos = GetRandomValue(0, SCREEN_HEIGHT);
-            iaHitPos = 0.0f;
+            tickButtons = KeysButtons(InputSamplerKeysAt(&inputSampler, tickEnd));
+            if (spawnRequested) {
+                tickButtons |= BUTTON_SPAWN;
+                spawnRequested = false;
+            }
         }
+        ReplayWriteTick(&replay, tickButtons);
 
-        // speed up ball
-        ball.speed = BALL_INITIAL_SPEED + BALL_SPEED_INCREMENT * sqrtf(++hitCounter);
-
-        // reset timer for ia
-        iaTimer = 0.0f;
-
-        PlaySound(soundBeep);
-    }
-
-    // reflect ball screen border
-    if (ball.rect.y < LIMIT_TOP) {
-        ball.rect.y = LIMIT_TOP;
-        ball.dir.y *= -1.0f;
-    } else if (ball.rect.y + ball.rect.height > LIMIT_BOTTOM) {
-        ball.rect.y = LIMIT_BOTTOM - ball.rect.height;
-        ball.dir.y *= -1.0f;
-    }
+        previousGame = game;
+        StepGame(tickButtons);
 
-    if (ball.rect.x + ball.rect.width < 0.0f) {
-        ResetBall();
-        ++rightScore;
-        TraceLog(LOG_DEBUG, "Score: %dx%d", leftScore, rightScore);
-    } else if (ball.rect.x > SCREEN_WIDTH) {
-        ResetBall();
-        ++leftScore;
-        TraceLog(LOG_DEBUG, "Score: %dx%d", leftScore, rightScore);
-    }
+        if (!replayFast) {
+            PlayTickSounds();
+        }
+        if (game.events & (PONG_EVENT_SCORE_LEFT | PONG_EVENT_SCORE_RIGHT)) {
+            // ball was served again, don't interpolate across the field
+            previousGame.ball = game.ball;
+            TraceLog(LOG_DEBUG, "Score: %dx%d", game.leftScore, game.rightScore);
+        }
 
-    // Check game over
-    if (leftScore > 9 || rightScore > 9) {
-        TraceLog(LOG_DEBUG, "Game over");
-        SetNextScreen(SCREEN_GAME_OVER);
+        // Check game over
+        if (game.events & PONG_EVENT_GAME_OVER) {
+            TraceLog(LOG_DEBUG, "Game over");
+            EndGame(SCREEN_GAME_OVER);
+            break;
+        }
     }
+    gameAlpha = TickClockAlpha(&gameClock, PONG_TICK_DT);
 }
 
-void RenderGameScreen(void) {
+static void RenderGameScreen(float fading) {
     static Color fadeColor;
-    fadeColor = Fade(COLOR_FG, screenFade / SCREEN_FADE_TIME);
+    fadeColor = Fade(COLOR_FG, fading);
 
     // draw borders
-    DrawRectangle(0, 0, SCREEN_WIDTH, BORDER_WIDTH, fadeColor);
-    DrawRectangle(0, SCREEN_HEIGHT - BORDER_WIDTH, SCREEN_WIDTH, BORDER_WIDTH,
-                  fadeColor);
+    DrawListRectangle(&drawList, (Rectangle){0, 0, SCREEN_WIDTH, BORDER_WIDTH},
+                      fadeColor);
+    DrawListRectangle(
+        &drawList,
+        (Rectangle){0, SCREEN_HEIGHT - BORDER_WIDTH, SCREEN_WIDTH, BORDER_WIDTH},
+        fadeColor);
+
+    // interpolate between the last two ticks
+    Rectangle leftRect =
+        LerpRect(previousGame.leftPaddle.rect, game.leftPaddle.rect, gameAlpha);
+    Rectangle rightRect =
+        LerpRect(previousGame.rightPaddle.rect, game.rightPaddle.rect, gameAlpha);
+    Rectangle ballRect = LerpRect(previousGame.ball.rect, game.ball.rect, gameAlpha);
+    DrawListRectangle(&drawList, leftRect, fadeColor);
+    DrawListRectangle(&drawList, rightRect, fadeColor);
+    DrawListRectangle(&drawList, ballRect, fadeColor);
+
+    if (gameMode == MODE_BRICK_ARENA) {
+        for (int i = 0; i < brickGrid.brickCount; ++i) {
+            if (brickGrid.alive[i]) {
+                DrawListRectangle(&drawList, brickGrid.bricks[i], fadeColor);
+            }
+        }
+    }
 
-    DrawRectangleRec(leftPaddle.rect, fadeColor);
-    DrawRectangleRec(rightPaddle.rect, fadeColor);
-    DrawRectangleRec(ball.rect, fadeColor);
+    for (int i = 0; i < ballPool.count; ++i) {
+        float x = Lerp(ballPool.prevX[i], ballPool.x[i], gameAlpha);
+        float y = Lerp(ballPool.prevY[i], ballPool.y[i], gameAlpha);
+        DrawListRectangle(&drawList, (Rectangle){x, y, BALL_WIDTH, BALL_HEIGHT},
+                          fadeColor);
+    }
 
     // middle line
     int xMiddle = (SCREEN_WIDTH - BALL_WIDTH) / 2.0f;
     for (int y = 2 * BORDER_WIDTH; y < SCREEN_HEIGHT; y += 2 * BALL_HEIGHT) {
-        DrawRectangle(xMiddle, y, BALL_WIDTH, BALL_HEIGHT, fadeColor);
+        DrawListRectangle(&drawList, (Rectangle){xMiddle, y, BALL_WIDTH, BALL_HEIGHT},
+                          fadeColor);
     }
 
     // Draw score
     int fontSize = 90;
-    const char *leftScoreText = TextFormat("%d", leftScore);
-    const char *rightScoreText = TextFormat("%d", rightScore);
-    int leftTextSize = MeasureText(leftScoreText, fontSize);
-    int rightTextSize = MeasureText(rightScoreText, fontSize);
-
-    DrawText(leftScoreText, 3.0f * SCREEN_WIDTH / 8.0f - leftTextSize / 2.0f, 50,
-             fontSize, fadeColor);
-    DrawText(rightScoreText, 5.0f * SCREEN_WIDTH / 8.0f - rightTextSize / 2.0f, 50,
-             fontSize, fadeColor);
+    const char *leftScoreText = TextFormat("%d", game.leftScore);
+    const char *rightScoreText = TextFormat("%d", game.rightScore);
+    int leftTextSize = DrawListMeasureText(&drawList, leftScoreText, fontSize);
+    int rightTextSize = DrawListMeasureText(&drawList, rightScoreText, fontSize);
+
+    DrawListText(&drawList, leftScoreText,
+                 3.0f * SCREEN_WIDTH / 8.0f - leftTextSize / 2.0f, 50, fontSize,
+                 fadeColor);
+    DrawListText(&drawList, rightScoreText,
+                 5.0f * SCREEN_WIDTH / 8.0f - rightTextSize / 2.0f, 50, fontSize,
+                 fadeColor);
+
+    if (netPlay.status == NET_CONNECTING) {
+        const char *waiting = "WAITING FOR THE OTHER PLAYER";
+        int waitingSize = DrawListMeasureText(&drawList, waiting, 24);
+        DrawListText(&drawList, waiting, (SCREEN_WIDTH - waitingSize) / 2.0f, 400, 24,
+                     fadeColor);
+    }
 
     if (debugMode) {
-        // bounce points
-        DrawRectangleV(bouncePoints[0], (Vector2){BALL_WIDTH, BALL_HEIGHT}, GREEN);
-        for (int i = 1; i <= bouncePointsCount && i < BOUNCE_POINTS_MAX; ++i) {
-            DrawRectangleV(bouncePoints[i], (Vector2){BALL_WIDTH, BALL_HEIGHT}, GREEN);
-            DrawLineV(bouncePoints[i - 1], bouncePoints[i], GREEN);
+        // overlays go over the game, they can't be sorted under it
+        DrawListLayer(&drawList, 1);
+
+        // bounce points, only walked here since the IA uses the closed-form landing
+        Vector2 bouncePoints[BOUNCE_POINTS_MAX];
+        int bouncePointsCount = CalculateBouncePoints(game.ball, bouncePoints);
+        for (int i = 0; i <= bouncePointsCount; ++i) {
+            Rectangle point = {bouncePoints[i].x, bouncePoints[i].y, BALL_WIDTH,
+                               BALL_HEIGHT};
+            DrawListRectangle(&drawList, point, GREEN);
+            if (i > 0) {
+                DrawListLine(&drawList, bouncePoints[i - 1], bouncePoints[i], GREEN);
+            }
+        }
+
+        Vector2 lineStarts[4], lineEnds[4];
+        GetBounceLines(lineStarts, lineEnds);
+        for (int i = 0; i < 4; ++i) {
+            DrawListLineEx(&drawList, lineStarts[i], lineEnds[i], 2.0f, BLUE);
         }
 
-        DrawLineEx(topSP, topEP, 2.0f, BLUE);
-        DrawLineEx(rightSP, rightEP, 2.0f, BLUE);
-        DrawLineEx(bottomSP, bottomEP, 2.0f, BLUE);
-        DrawLineEx(leftSP, leftEP, 2.0f, BLUE);
+        if (UsesBallPool()) {
+            const char *counts = TextFormat("BALLS: %d BRICKS: %d", ballPool.count,
+                                            brickGrid.aliveCount);
+            DrawListText(&drawList, counts, 20, SCREEN_HEIGHT - 40, 20, GREEN);
+        }
+        if (netPlay.status != NET_CLOSED) {
+            NetStats *stats = &netPlay.stats;
+            const char *netStats =
+                TextFormat("ROLLBACK: %d (MAX %d) RESIM: %.3f MS (MAX %.3f) "
+                           "STALLS: %lld",
+                           stats->rollbackTicks, stats->rollbackMax,
+                           1000.0 * stats->resimTime, 1000.0 * stats->resimMax,
+                           stats->stalls);
+            DrawListText(&drawList, netStats, 20, SCREEN_HEIGHT - 40, 20, GREEN);
+        }
     }
 }
 
-void InitGameOverScreen(void) {
+static void InitGameOverScreen(void) {
     menuGOverOption = MENU_GO_PLAY;
     menuBlinkTimer = 0.0f;
     TraceLog(LOG_DEBUG, "Init Game Over screen");
 }
 
-void UpdateGameOverScreen(float dt) {
+static void UpdateGameOverScreen(float dt) {
     if (IsKeyPressed(KEY_ENTER)) {
         SetNextScreen(SCREEN_MENU);
     }
@@ -550,276 +716,487 @@ void UpdateGameOverScreen(float dt) {
     menuBlinkTimer += dt;
 }
 
-void RenderGameOverScreen(void) {
+static void RenderGameOverScreen(float fading) {
     Color fadeColor;
 
-    fadeColor = Fade(COLOR_FG, screenFade / SCREEN_FADE_TIME);
+    fadeColor = Fade(COLOR_FG, fading);
 
     // draw header
     const char *leftWin = "LEFT PLAYER WIN";
     const char *rightWin = "RIGHT PLAYER WIN";
-    const char *winMsg = leftScore > rightScore ? leftWin : rightWin;
-    int titleMeasure = MeasureText(winMsg, 48);
-    DrawText(winMsg, (SCREEN_WIDTH - titleMeasure) / 2.0f, 150, 48, fadeColor);
+    const char *winMsg = game.leftScore > game.rightScore ? leftWin : rightWin;
+    int titleMeasure = DrawListMeasureText(&drawList, winMsg, 48);
+    DrawListText(&drawList, winMsg, (SCREEN_WIDTH - titleMeasure) / 2.0f, 150, 48,
+                 fadeColor);
 
     // draw menu options
     const char *options[] = {"PLAY AGAIN", "MAIN_MENU"};
     RenderMenuOptions(options, 2, menuGOverOption, fadeColor);
 }
 
-void ResetBall(void) {
-    hitCounter = 0;
-    ball.speed = BALL_INITIAL_SPEED;
+static void StartGame(unsigned int seed, PaddleControl rightControl) {
+    PaddleControl left = gameMode == MODE_TWO_PLAYERS ? CONTROL_PLAYER : CONTROL_IA;
+    PongInit(&game, seed, left, rightControl);
+    PongSetDifficulty(&game, iaDifficulty, iaDifficulty);
 
-    ball.rect.x = (SCREEN_WIDTH - ball.rect.width) / 2.0f;
-    ball.rect.y = (SCREEN_HEIGHT - ball.rect.height) / 2.0f;
-    ball.dir.x = GetRandomValue(0, 1) == 0 ? -1.0f : 1.0f;
-    ball.dir.y = GetRandomValue(0, 1000) / 1000.0f;
-    ball.dir = Vector2Normalize(ball.dir);
+    // the pool is reseeded from the match, so replays spawn the same balls
+    if (UsesBallPool() && ballPool.capacity == 0) {
+        ballPool = CreateBallPool(BALL_POOL_CAPACITY, game.rngState);
+    }
+    ballPool.count = 0;
+    ballPool.rngState = game.rngState;
+    if (gameMode == MODE_MULTI_BALL) {
+        SpawnBalls(&ballPool, MULTI_BALL_START);
+    }
 
-    if (ball.dir.x < 0.0f) {
-        CalculateBouncePoints();
-        iaTargetPos = bouncePoints[bouncePointsCount].y;
+    if (gameMode == MODE_BRICK_ARENA) {
+        if (brickGrid.brickCount == 0) {
+            brickGrid = CreateBrickGrid(ARENA_AREA, ARENA_BRICK_WIDTH,
+                                        ARENA_BRICK_HEIGHT, ARENA_BRICK_GAP,
+                                        ARENA_CELL_SIZE);
+        }
+        ResetBrickGrid(&brickGrid);
     }
 }
 
-float KeyboardInput(void) {
-    float input = 0.0f;
-
-    if (IsKeyDown(KEY_UP)) {
-        input -= 1.0f;
+static void StepGame(unsigned int buttons) {
+    PongInput input = {.leftMove = 0.0f, .rightMove = 0.0f};
+    if (buttons & BUTTON_UP) {
+        input.rightMove -= 1.0f;
     }
-    if (IsKeyDown(KEY_DOWN)) {
-        input += 1.0f;
+    if (buttons & BUTTON_DOWN) {
+        input.rightMove += 1.0f;
+    }
+    if (buttons & BUTTON_LEFT_UP) {
+        input.leftMove -= 1.0f;
+    }
+    if (buttons & BUTTON_LEFT_DOWN) {
+        input.leftMove += 1.0f;
+    }
+    if (UsesBallPool() && (buttons & BUTTON_SPAWN)) {
+        SpawnBalls(&ballPool, MULTI_BALL_STEP);
+        TraceLog(LOG_DEBUG, "Balls: %d", ballPool.count);
     }
 
-    return input;
+    BrickGrid *bricks = gameMode == MODE_BRICK_ARENA ? &brickGrid : NULL;
+    PongStepBricks(&game, input, PONG_TICK_DT, bricks);
+    poolHits = 0;
+    if (ballPool.count > 0) {
+        poolHits = UpdateBallPool(&ballPool, &game, bricks, PONG_TICK_DT);
+    }
+    if (bricks != NULL && bricks->aliveCount == 0) {
+        ResetBrickGrid(bricks);
+    }
 }
 
-void RenderMenuOptions(const char **options, int numOptions, int currentOption,
-                       Color fadeColor) {
-    static bool blink = true;
-
-    int yPos = 400;
+static void UpdateNetGame(float dt) {
+    NetPlayPoll(&netPlay, &game);
+    if (netPlay.status == NET_TIMED_OUT) {
+        TraceLog(LOG_WARNING, "Netplay peer timed out");
+        EndGame(SCREEN_MENU);
+        return;
+    }
 
-    if (menuBlinkTimer > 0.3f) {
-        menuBlinkTimer -= 0.3f;
-        blink = !blink;
+    // the local paddle takes the arrows, whichever side it is on
+    unsigned int buttons = 0;
+    if (IsKeyDown(KEY_UP)) {
+        buttons |= NET_BUTTON_UP;
+    }
+    if (IsKeyDown(KEY_DOWN)) {
+        buttons |= NET_BUTTON_DOWN;
     }
 
-    for (int i = 0; i < numOptions; ++i) {
-        Color blinkColor = blink ? COLOR_FG : COLOR_BG;
-        Color finalColor = currentOption == i ? blinkColor : COLOR_FG;
-        if (screenFade < SCREEN_FADE_TIME) {
-            // override fading color
-            finalColor = fadeColor;
+    TickClockAdvance(&gameClock, dt);
+    while (TickClockConsume(&gameClock, PONG_TICK_DT)) {
+        // too far ahead of the peer, wait for its inputs
+        previousGame = game;
+        if (!NetPlayAdvance(&netPlay, &game, buttons)) {
+            break;
         }
 
-        int optionMeasure = MeasureText(options[i], 24);
-        DrawText(options[i], (SCREEN_WIDTH - optionMeasure) / 2.0f, yPos, 24,
-                 finalColor);
-        yPos += 40;
+        PlayTickSounds();
+        if (game.events & (PONG_EVENT_SCORE_LEFT | PONG_EVENT_SCORE_RIGHT)) {
+            previousGame.ball = game.ball;
+        }
+    }
+    NetPlaySend(&netPlay);
+    gameAlpha = TickClockAlpha(&gameClock, PONG_TICK_DT);
+
+    // a predicted game over may still be rolled back, only a confirmed one counts
+    if (PongIsOver(&game) && NetPlayIsConfirmed(&netPlay)) {
+        TraceLog(LOG_DEBUG, "Game over");
+        EndGame(SCREEN_GAME_OVER);
     }
 }
 
-void InitAssets(void) {
-    ChangeDirectory(ASSET_PATH);
-    soundBeep = LoadSound("sound.wav");
+static void EndGame(ScreenState screen) {
+    // playback only shows its own match, recording closes the file of this one
+    if (replay.mode == REPLAY_PLAY) {
+        ReportReplay(GetTime() - replayStart);
+        screen = SCREEN_NONE;
+    }
+    DestroyReplay(&replay);
+    DestroyNetPlay(&netPlay);
+    SetNextScreen(screen);
 }
 
-void DestroyAssets(void) {
-    UnloadSound(soundBeep);
+static void ReportReplay(double elapsed) {
+    printf("replay: %u ticks (%.1f s of play) in %.3f s, score %dx%d\n", replay.ticks,
+           replay.ticks * PONG_TICK_DT, elapsed, game.leftScore, game.rightScore);
 }
 
-bool ResolveCollBallPaddle(Entity paddle, Vector2 ballVel) {
-    Rectangle ballRectSwept = SweptRectangle(ball.rect, ballVel);
-    CollisionData collData = {0};
+#if !defined(ARCADE)
+static int RunReplay(void) {
+    // no window, the match runs as fast as the replay decodes
+    StartGame(replay.header.seed, CONTROL_PLAYER);
+
+    clock_t start = clock();
+    unsigned int buttons;
+    while (ReplayReadTick(&replay, &buttons)) {
+        StepGame(buttons);
+        if (game.events & PONG_EVENT_GAME_OVER) {
+            break;
+        }
+    }
+    ReportReplay((double)(clock() - start) / CLOCKS_PER_SEC);
 
-    if (AABBCheck(ballRectSwept, paddle.rect)) {
-        collData = SweptAABB(ball.rect, ballVel, paddle.rect);
-        if (collData.hit) {
-            ball.rect.x = collData.contactPoint.x;
-            ball.rect.y = collData.contactPoint.y;
+    DestroyReplay(&replay);
+    DestroyBallPool(&ballPool);
+    DestroyBrickGrid(&brickGrid);
 
-            if (collData.contactNormal.x == 0) {
-                // colided from top or bottom
-                ball.dir.y *= -1.0f;
-            } else {
-                // collided from the front
-                ball.dir.x *= -1.0f;
-                ball.dir.y = (2 * (ball.rect.y - paddle.rect.y + ball.rect.height) /
-                              (PADDLE_HEIGHT + ball.rect.height)) -
-                             1.0f;
-                ball.dir = Vector2Normalize(ball.dir);
+    return 0;
+}
+
+static int RunGolden(const char *path, bool update) {
+    // no window, every screen is rendered into a CPU raster at a few fade levels
+    static const GoldenScreen goldens[] = {
+        {"menu", SCREEN_MENU, MODE_CLASSIC, false},
+        {"classic", SCREEN_GAME, MODE_CLASSIC, false},
+        {"two_players", SCREEN_GAME, MODE_TWO_PLAYERS, false},
+        {"multi_ball", SCREEN_GAME, MODE_MULTI_BALL, false},
+        {"brick_arena", SCREEN_GAME, MODE_BRICK_ARENA, false},
+        {"debug", SCREEN_GAME, MODE_BRICK_ARENA, true},
+        {"game_over", SCREEN_GAME_OVER, MODE_CLASSIC, false}};
+    int goldenCount = sizeof(goldens) / sizeof(GoldenScreen);
+
+    Raster raster = CreateRaster(SCREEN_WIDTH, SCREEN_HEIGHT);
+    drawList = CreateDrawList(&raster);
+    GoldenSet set = LoadGoldenSet(path);
+
+    for (int i = 0; i < goldenCount; ++i) {
+        SetupGolden(&goldens[i]);
+        for (int fade = 0; fade < GOLDEN_FADES; ++fade) {
+            RenderGolden(&goldens[i], &raster, (float)fade / (GOLDEN_FADES - 1));
+
+            char name[GOLDEN_NAME_SIZE];
+            snprintf(name, sizeof(name), "%s_%d", goldens[i].name,
+                     100 * fade / (GOLDEN_FADES - 1));
+            GoldenResult result = CheckGolden(&set, name, &raster, update);
+            if (result != GOLDEN_MATCH) {
+                printf("%s: %s\n", name, result == GOLDEN_MISMATCH ? "differs" : "new");
             }
         }
+
+        // render speed of the fully faded in screen, the last one checked
+        clock_t start = clock();
+        int frames = 0;
+        double elapsed = 0.0;
+        while (elapsed < GOLDEN_BENCH_TIME) {
+            RenderGolden(&goldens[i], &raster, 1.0f);
+            ++frames;
+            elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+        }
+        printf("%-12s %8.0f frames/s\n", goldens[i].name, frames / elapsed);
     }
 
-    return collData.hit;
-}
+    printf("golden: %d match, %d differ, %d new\n", set.matched, set.mismatched,
+           set.missing);
+    if (update && !SaveGoldenSet(&set)) {
+        fprintf(stderr, "%s: can't write the golden hashes\n", path);
+    } else if (!update && set.missing > 0) {
+        fprintf(stderr, "%s: frames without a hash, record them with --update\n", path);
+    }
 
-void CalculateBouncePoints(void) {
-    Vector2 curDir, hitPoint;
-    bool hitTop, hitRight, hitBottom, hitLeft;
-    float hitTime;
+    DestroyDrawList(&drawList);
+    DestroyRaster(&raster);
+    DestroyBallPool(&ballPool);
+    DestroyBrickGrid(&brickGrid);
 
-    // the first point is where the ball is
-    bouncePointsCount = 0;
-    bouncePoints[0] = (Vector2){ball.rect.x, ball.rect.y};
-    curDir = ball.dir;
+    return !update && (set.mismatched > 0 || set.missing > 0) ? 1 : 0;
+}
 
-    while (bouncePointsCount < BOUNCE_POINTS_MAX) {
-        // check top bounce
-        if (curDir.y < 0.0f) {
-            hitTop = RayIntersectLine(bouncePoints[bouncePointsCount], curDir, topSP,
-                                      topEP, &hitPoint, &hitTime);
-            if (hitTop) {
-                curDir = Vector2Reflect(curDir, (Vector2){0.0f, 1.0f});
-                bouncePoints[++bouncePointsCount] = hitPoint;
-                continue;
-            }
+static void SetupGolden(const GoldenScreen *golden) {
+    gameMode = golden->mode;
+    debugMode = golden->debug;
+    menuOption = MENU_TWO_PLAYERS;
+    menuGOverOption = MENU_GO_PLAY;
+    menuBlinkTimer = 0.0f;
+
+    // the right paddle goes up and down, the left one too in two players mode, and
+    // the ball pool gets one extra spawn
+    StartGame(GOLDEN_SEED, CONTROL_PLAYER);
+    for (int tick = 0; tick < GOLDEN_TICKS; ++tick) {
+        unsigned int buttons = (tick / PONG_TICK_RATE) % 2 == 0
+                                   ? BUTTON_UP | BUTTON_LEFT_DOWN
+                                   : BUTTON_DOWN | BUTTON_LEFT_UP;
+        if (tick == PONG_TICK_RATE) {
+            buttons |= BUTTON_SPAWN;
         }
+        previousGame = game;
+        StepGame(buttons);
+    }
+    gameAlpha = 0.5f;
+}
+
+static void RenderGolden(const GoldenScreen *golden, Raster *raster, float fading) {
+    RasterClear(raster, BLACK);
+    CreateScreen(golden->screen).render(fading);
+    DrawListSubmit(&drawList);
+}
+
+static int RunExport(const char *path, VideoFormat format) {
+    // raylib logs to stdout, which may be the stream itself
+    SetTraceLogLevel(LOG_NONE);
+
+    VideoWriter writer =
+        CreateVideoWriter(path, format, SCREEN_WIDTH, SCREEN_HEIGHT, EXPORT_FPS);
+    if (!StartVideoWriter(&writer)) {
+        fprintf(stderr, "%s: can't write the video\n", path);
+        DestroyVideoWriter(&writer);
+        DestroyReplay(&replay);
+        return 1;
+    }
 
-        if (curDir.x > 0.0f) {
-            hitRight = RayIntersectLine(bouncePoints[bouncePointsCount], curDir,
-                                        rightSP, rightEP, &hitPoint, &hitTime);
-            if (hitRight) {
-                curDir = Vector2Reflect(curDir, (Vector2){-1.0f, 0.0f});
-                bouncePoints[++bouncePointsCount] = hitPoint;
+    // without a replay the IA plays both paddles
+    bool playing = replay.mode == REPLAY_PLAY;
+    if (playing) {
+        StartGame(replay.header.seed, CONTROL_PLAYER);
+    } else {
+        StartGame((unsigned int)time(NULL), CONTROL_IA);
+    }
+    previousGame = game;
+    gameClock = CreateTickClock(TICK_CATCHUP_MAX);
+
+    // no window, the match runs at the video rate and every frame is drawn on the
+    // CPU into the next free raster of the writer, as fast as the encoder takes them
+    drawList = CreateDrawList(&writer.frames[0]);
+    bool over = false;
+    for (int frames = 0; !over && frames < EXPORT_FPS * EXPORT_SECONDS_MAX; ++frames) {
+        TickClockAdvance(&gameClock, 1.0f / EXPORT_FPS);
+        while (TickClockConsume(&gameClock, PONG_TICK_DT)) {
+            unsigned int buttons = 0;
+            if (playing && !ReplayReadTick(&replay, &buttons)) {
+                over = true;
                 break;
             }
-        }
-
-        // check bottom bounce
-        if (curDir.y > 0.0f) {
-            hitBottom = RayIntersectLine(bouncePoints[bouncePointsCount], curDir,
-                                         bottomSP, bottomEP, &hitPoint, &hitTime);
-            if (hitBottom) {
-                curDir = Vector2Reflect(curDir, (Vector2){0.0f, -1.0f});
-                bouncePoints[++bouncePointsCount] = hitPoint;
-                continue;
+            previousGame = game;
+            StepGame(buttons);
+            if (game.events & (PONG_EVENT_SCORE_LEFT | PONG_EVENT_SCORE_RIGHT)) {
+                previousGame.ball = game.ball;
             }
-        }
-
-        if (curDir.x < 0.0f) {
-            hitLeft = RayIntersectLine(bouncePoints[bouncePointsCount], curDir, leftSP,
-                                       leftEP, &hitPoint, &hitTime);
-            if (hitLeft) {
-                curDir = Vector2Reflect(curDir, (Vector2){1.0f, 0.0f});
-                bouncePoints[++bouncePointsCount] = hitPoint;
+            if (game.events & PONG_EVENT_GAME_OVER) {
+                over = true;
                 break;
             }
         }
+        gameAlpha = TickClockAlpha(&gameClock, PONG_TICK_DT);
 
-        // we can break if don't reach any of the above
-        break;
+        Raster *frame = VideoWriterAcquire(&writer);
+        if (frame == NULL) {
+            break;
+        }
+        drawList.raster = frame;
+        RasterClear(frame, COLOR_BG);
+        RenderGameScreen(1.0f);
+        DrawListSubmit(&drawList);
+        VideoWriterSubmit(&writer);
     }
-}
-
-bool RayIntersectLine(Vector2 rayOrigin, Vector2 rayDir, Vector2 lineStart,
-                      Vector2 lineEnd, Vector2 *collPoint, float *collTime) {
-    Vector2 a = rayOrigin, r = rayDir;
-    Vector2 c = lineStart, s = Vector2Subtract(lineEnd, lineStart);
 
-    float rCrossS = Vector2CrossProduct(r, s);
-    if (FloatEquals(rCrossS, 0.0f)) {
-        return false;
+    bool written = DestroyVideoWriter(&writer);
+    VideoWriterReport(&writer);
+    if (!written) {
+        fprintf(stderr, "%s: the video could not be written\n", path);
     }
 
-    float t1 = Vector2CrossProduct(Vector2Subtract(c, a), s) / rCrossS;
-    float t2 = Vector2CrossProduct(Vector2Subtract(c, a), r) / rCrossS;
+    DestroyDrawList(&drawList);
+    DestroyReplay(&replay);
+    DestroyBallPool(&ballPool);
+    DestroyBrickGrid(&brickGrid);
 
-    if (t1 >= 0.0f && (0.0f <= t2 && t2 <= 1.0f)) {
-        *collPoint = Vector2Add(a, Vector2Scale(r, t1));
-        *collTime = t1;
-        return true;
-    }
+    return written ? 0 : 1;
+}
+#endif
 
-    return false;
+static bool UsesBallPool(void) {
+    return gameMode == MODE_MULTI_BALL || gameMode == MODE_BRICK_ARENA;
 }
 
-float Vector2CrossProduct(Vector2 v1, Vector2 v2) { return v1.x * v2.y - v1.y * v2.x; }
+static unsigned int KeyboardKeys(void) {
+    unsigned int keys = 0;
 
-bool AABBCheck(Rectangle rect1, Rectangle rect2) {
-    return !(rect1.x + rect1.width < rect2.x || rect1.x > rect2.x + rect2.width ||
-             rect1.y + rect1.height < rect2.y || rect1.y > rect2.y + rect2.height);
+    if (IsKeyDown(KEY_UP)) {
+        keys |= INPUT_KEY_UP;
+    }
+    if (IsKeyDown(KEY_DOWN)) {
+        keys |= INPUT_KEY_DOWN;
+    }
+    if (IsKeyDown(KEY_W)) {
+        keys |= INPUT_KEY_W;
+    }
+    if (IsKeyDown(KEY_S)) {
+        keys |= INPUT_KEY_S;
+    }
+
+    return keys;
 }
 
-Rectangle SweptRectangle(Rectangle rect, Vector2 vel) {
-    Rectangle sweptRect = {
-        .x = vel.x > 0.0f ? rect.x : rect.x + vel.x,
-        .y = vel.y > 0.0f ? rect.y : rect.y + vel.y,
-        .width = vel.x > 0.0f ? rect.width + vel.x : rect.width - vel.x,
-        .height = vel.y > 0.0f ? rect.height + vel.y : rect.height - vel.y};
+static unsigned int KeysButtons(unsigned int keys) {
+    unsigned int buttons = 0;
 
-    return sweptRect;
+    if (keys & INPUT_KEY_UP) {
+        buttons |= BUTTON_UP;
+    }
+    if (keys & INPUT_KEY_DOWN) {
+        buttons |= BUTTON_DOWN;
+    }
+    if (gameMode == MODE_TWO_PLAYERS && (keys & INPUT_KEY_W)) {
+        buttons |= BUTTON_LEFT_UP;
+    }
+    if (gameMode == MODE_TWO_PLAYERS && (keys & INPUT_KEY_S)) {
+        buttons |= BUTTON_LEFT_DOWN;
+    }
+
+    return buttons;
 }
 
-CollisionData SweptAABB(Rectangle rect, Vector2 vel, Rectangle target) {
-    CollisionData data;
-    Vector2 invEntry, entry, invExit, exit;
-    float entryTime, exitTime;
+static Rectangle LerpRect(Rectangle from, Rectangle to, float amount) {
+    Rectangle rect = {.x = from.x + (to.x - from.x) * amount,
+                      .y = from.y + (to.y - from.y) * amount,
+                      .width = to.width,
+                      .height = to.height};
+    return rect;
+}
 
-    // initialize data with no collision
-    data.hit = false;
-    data.time = 1.0f;
-    data.contactPoint = Vector2Zero();
-    data.contactNormal = Vector2Zero();
+static void RenderMenuOptions(const char **options, int numOptions,
+                              int currentOption, Color fadeColor) {
+    static bool blink = true;
 
-    // find the distance between the objects on the near and far sides for both
-    // x and y
-    if (vel.x > 0.0f) {
-        invEntry.x = target.x - (rect.x + rect.width);
-        invExit.x = (target.x + target.width) - rect.x;
-    } else {
-        invEntry.x = (target.x + target.width) - rect.x;
-        invExit.x = target.x - (rect.x + rect.width);
-    }
+    int yPos = 400;
 
-    if (vel.y > 0.0f) {
-        invEntry.y = target.y - (rect.y + rect.height);
-        invExit.y = (target.y + target.height) - rect.y;
-    } else {
-        invEntry.y = (target.y + target.height) - rect.y;
-        invExit.y = target.y - (rect.y + rect.height);
+    if (menuBlinkTimer > 0.3f) {
+        menuBlinkTimer -= 0.3f;
+        blink = !blink;
     }
 
-    // find time of collision and time of leaving for each axis
-    entry = (Vector2){-INFINITY, -INFINITY};
-    exit = (Vector2){INFINITY, INFINITY};
+    for (int i = 0; i < numOptions; ++i) {
+        Color blinkColor = blink ? COLOR_FG : COLOR_BG;
+        Color finalColor = currentOption == i ? blinkColor : COLOR_FG;
+        if (fadeColor.a < COLOR_FG.a) {
+            // override fading color
+            finalColor = fadeColor;
+        }
 
-    if (vel.x != 0) {
-        entry.x = invEntry.x / vel.x;
-        exit.x = invExit.x / vel.x;
+        int optionMeasure = DrawListMeasureText(&drawList, options[i], 24);
+        DrawListText(&drawList, options[i], (SCREEN_WIDTH - optionMeasure) / 2.0f, yPos,
+                     24, finalColor);
+        yPos += 40;
     }
+}
 
-    if (vel.y != 0) {
-        entry.y = invEntry.y / vel.y;
-        entry.y = invEntry.y / vel.y;
+static void InitAssets(void) {
+    TRACE_BEGIN("InitAssets");
+    // only the index is read here, the loader thread pages the rest in
+    const char *packPath =
+        TextFormat("%s%s", GetApplicationDirectory(), ASSET_PACK_FILE);
+    assetPack = OpenAssetPack(packPath);
+    if (!StartAssetPack(&assetPack) && assetPack.data == NULL) {
+        TraceLog(LOG_WARNING, "Asset pack %s not found, playing without sound",
+                 packPath);
+    }
+    drawList = CreateDrawList(NULL);
+
+    // no allocation once it plays, the clips are made before the first sound
+    mixer = CreateAudioMixer();
+    clipBeep = MixerSynthSquare(&mixer, 440.0f, 0.08f, 0.25f);
+    clipBrick = MixerSynthSquare(&mixer, 880.0f, 0.04f, 0.2f);
+    if (!StartAudioMixer(&mixer)) {
+        TraceLog(LOG_WARNING, "Audio mixer not started, playing without sound");
     }
 
-    entryTime = fmaxf(entry.x, entry.y);
-    exitTime = fminf(exit.x, exit.y);
+    inputSampler = CreateInputSampler();
+    if (inputThread && StartInputSampler(&inputSampler)) {
+        TraceLog(LOG_INFO, "Input sampler reading %d keyboards",
+                 inputSampler.deviceCount);
+    } else {
+        TraceLog(LOG_INFO, "Input polled every frame");
+    }
+    TRACE_END();
+}
 
-    if (entryTime > exitTime || (entry.x < 0.0f && entry.y < 0.0f) || entry.x > 1.0f ||
-        entry.y > 1.0f) {
-        // no collision
-        return data;
+static void DestroyAssets(void) {
+    DestroyReplay(&replay);
+    DestroyNetPlay(&netPlay);
+    // the stream callback writes the latencies, it is stopped before they are read
+    DestroyAudioMixer(&mixer);
+    if (audioLatencyMode) {
+        MixerReport(&mixer);
+    }
+    soundsLoaded = false;
+    DestroyAssetPack(&assetPack);
+    DestroyBallPool(&ballPool);
+    DestroyBrickGrid(&brickGrid);
+    DestroyDrawList(&drawList);
+    if (inputLatencyMode) {
+        InputSamplerReport(&inputSampler);
     }
+    DestroyInputSampler(&inputSampler);
+}
 
-    // calculate normal
-    if (entry.x > entry.y) {
-        data.contactNormal.x = invEntry.x < 0.0f ? 1.0f : -1.0f;
-    } else {
-        data.contactNormal.y = invEntry.y < 0.0f ? 1.0f : -1.0f;
+static void PollAssets(void) {
+    // the mixer converts the samples straight from the mapping
+    if (soundsLoaded || !AssetPackLoaded(&assetPack)) {
+        return;
     }
+    const AssetEntry *beep = AssetPackFind(&assetPack, "sound", ASSET_SOUND);
+    int clip = beep != NULL ? MixerAddWave(&mixer, beep->wave) : -1;
+    clipBeep = clip >= 0 ? clip : clipBeep;
+    soundsLoaded = true;
+    TraceLog(LOG_DEBUG, "Asset pack: %d of %d entries loaded %.1f ms after opening it",
+             assetPack.validCount, assetPack.entryCount, 1000.0 * assetPack.loadTime);
+}
 
-    // calculate contact point
-    data.contactPoint.x = rect.x + vel.x * entryTime;
-    data.contactPoint.y = rect.y + vel.y * entryTime;
+static void PlayTickSounds(void) {
+    // the pool balls share a few sounds per tick, hundreds may hit at once
+    if (game.events & PONG_EVENT_HIT) {
+        PlayHitSound(game.ball.rect, game.ball.speed, 1.0f);
+    }
+    if (game.events & PONG_EVENT_BRICK) {
+        float pan = 2.0f * (game.ball.rect.x / SCREEN_WIDTH) - 1.0f;
+        MixerPlay(&mixer, clipBrick, 1.0f, 0.8f * pan, 1.0f);
+    }
+    int sounds = poolHits < POOL_HIT_SOUNDS_MAX ? poolHits : POOL_HIT_SOUNDS_MAX;
+    for (int i = 0; i < sounds; ++i) {
+        int ball = ballPool.hits[i];
+        Rectangle rect = {ballPool.x[ball], ballPool.y[ball], BALL_WIDTH, BALL_HEIGHT};
+        PlayHitSound(rect, ballPool.speed[ball], POOL_HIT_GAIN);
+    }
+}
 
-    data.hit = true;
-    data.time = entryTime;
+static void PlayHitSound(Rectangle ball, float speed, float gain) {
+    // an octave up every BALL_INITIAL_SPEED * 2 faster, two semitones up or down
+    // towards the paddle ends, panned to the side it was hit on
+    const Entity *paddle =
+        ball.x < SCREEN_WIDTH / 2.0f ? &game.leftPaddle : &game.rightPaddle;
+    float offset = (ball.y + ball.height / 2.0f - paddle->rect.y) / PADDLE_HEIGHT;
+    float semitones = 2.0f * (1.0f - 2.0f * Clamp(offset, 0.0f, 1.0f));
+    float octaves = (speed - BALL_INITIAL_SPEED) / (2.0f * BALL_INITIAL_SPEED);
+    float pitch = powf(2.0f, octaves + semitones / 12.0f);
+    float pan = 2.0f * ((ball.x + ball.width / 2.0f) / SCREEN_WIDTH) - 1.0f;
+
+    MixerPlay(&mixer, clipBeep, Clamp(pitch, 0.5f, 2.0f), 0.8f * pan, gain);
+}
 
-    return data;
+static void MarkInputPoll(void) {
+    // raylib polls the keys as the frame ends
+    inputPollTime = GetSeconds();
 }
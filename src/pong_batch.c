@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pong_sim.h"
+#include "tick.h"
+#include "work_pool.h"
+
+// Simulation constants
+#define MATCH_TICKS_MAX (PONG_TICK_RATE * 60 * 30)
+#define DEFAULT_MATCHES 10000
+
+// Rallies longer than this are counted in the last bucket
+#define RALLY_HISTOGRAM_SIZE 256
+
+#define CACHE_LINE_SIZE 64
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+// IA parameters under evaluation, applied to the left paddle
+typedef struct BatchConfig {
+    unsigned int seed;
+    float responseTime;
+    float iaSpeed;
+} BatchConfig;
+
+// Results of a single worker, merged once every match has been played
+typedef struct BatchStats {
+    long long matches, leftWins, rightWins, unfinished;
+    long long ticks, rallies, rallyHits;
+    int rallyMax;
+    long long rallyHistogram[RALLY_HISTOGRAM_SIZE];
+    char padding[CACHE_LINE_SIZE];
+} BatchStats;
+
+typedef struct BatchContext {
+    BatchConfig config;
+    BatchStats *stats; // one per worker
+} BatchContext;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+void PlayMatch(void *context, int worker, int index);
+void RecordRally(BatchStats *stats, int hits);
+void MergeStats(BatchStats *total, const BatchStats *stats);
+int RallyPercentile(const BatchStats *stats, float percentile);
+
+// -------------------------------------------------------------------------------------
+// Entrypoint
+// -------------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+    int matches = DEFAULT_MATCHES;
+    int threads = GetCoreCount();
+    BatchConfig config = {
+        .seed = 1, .responseTime = 0.5f, .iaSpeed = PADDLE_IA_SPEED};
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--matches") == 0 && i + 1 < argc) {
+            matches = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            config.seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--response-time") == 0 && i + 1 < argc) {
+            config.responseTime = strtof(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--ia-speed") == 0 && i + 1 < argc) {
+            config.iaSpeed = strtof(argv[++i], NULL);
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--matches N] [--threads N] [--seed S]\n"
+                    "          [--response-time SECONDS] [--ia-speed PIXELS]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    BatchContext context = {.config = config,
+                            .stats = calloc(threads, sizeof(BatchStats))};
+
+    double start = GetSeconds();
+    RunWorkPool(matches, threads, PlayMatch, &context);
+    double elapsed = GetSeconds() - start;
+
+    BatchStats total = {0};
+    for (int i = 0; i < threads; ++i) {
+        MergeStats(&total, &context.stats[i]);
+    }
+    free(context.stats);
+
+    double played = total.matches > 0 ? (double)total.matches : 1.0;
+    double rallies = total.rallies > 0 ? (double)total.rallies : 1.0;
+
+    printf("matches:      %lld on %d threads\n", total.matches, threads);
+    printf("left wins:    %lld (%.2f%%)\n", total.leftWins,
+           100.0 * total.leftWins / played);
+    printf("right wins:   %lld (%.2f%%)\n", total.rightWins,
+           100.0 * total.rightWins / played);
+    printf("unfinished:   %lld\n", total.unfinished);
+    printf("rallies:      %lld\n", total.rallies);
+    printf("rally hits:   mean %.2f, p50 %d, p99 %d, max %d\n",
+           total.rallyHits / rallies, RallyPercentile(&total, 0.5f),
+           RallyPercentile(&total, 0.99f), total.rallyMax);
+    printf("elapsed:      %.3f s\n", elapsed);
+    printf("matches/s:    %.0f\n", elapsed > 0.0 ? total.matches / elapsed : 0.0);
+    printf("ticks/s:      %.0f\n", elapsed > 0.0 ? total.ticks / elapsed : 0.0);
+
+    return 0;
+}
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+void PlayMatch(void *context, int worker, int index) {
+    BatchContext *batch = context;
+    BatchStats *stats = &batch->stats[worker];
+    PongInput input = {0};
+    PongState state;
+
+    PongInit(&state, batch->config.seed + (unsigned int)index, CONTROL_IA, CONTROL_IA);
+    state.leftIA.responseTime = batch->config.responseTime;
+    state.leftPaddle.speed = batch->config.iaSpeed;
+
+    int ticks = 0, rallyHits = 0;
+    while (!PongIsOver(&state) && ticks < MATCH_TICKS_MAX) {
+        PongStep(&state, input, PONG_TICK_DT);
+        ++ticks;
+
+        if (state.events & PONG_EVENT_HIT) {
+            ++rallyHits;
+        }
+        if (state.events & (PONG_EVENT_SCORE_LEFT | PONG_EVENT_SCORE_RIGHT)) {
+            RecordRally(stats, rallyHits);
+            rallyHits = 0;
+        }
+    }
+
+    ++stats->matches;
+    stats->ticks += ticks;
+    if (!PongIsOver(&state)) {
+        ++stats->unfinished;
+    } else if (state.leftScore > state.rightScore) {
+        ++stats->leftWins;
+    } else {
+        ++stats->rightWins;
+    }
+}
+
+void RecordRally(BatchStats *stats, int hits) {
+    ++stats->rallies;
+    stats->rallyHits += hits;
+    if (hits > stats->rallyMax) {
+        stats->rallyMax = hits;
+    }
+    ++stats->rallyHistogram[hits < RALLY_HISTOGRAM_SIZE ? hits
+                                                        : RALLY_HISTOGRAM_SIZE - 1];
+}
+
+void MergeStats(BatchStats *total, const BatchStats *stats) {
+    total->matches += stats->matches;
+    total->leftWins += stats->leftWins;
+    total->rightWins += stats->rightWins;
+    total->unfinished += stats->unfinished;
+    total->ticks += stats->ticks;
+    total->rallies += stats->rallies;
+    total->rallyHits += stats->rallyHits;
+    if (stats->rallyMax > total->rallyMax) {
+        total->rallyMax = stats->rallyMax;
+    }
+    for (int i = 0; i < RALLY_HISTOGRAM_SIZE; ++i) {
+        total->rallyHistogram[i] += stats->rallyHistogram[i];
+    }
+}
+
+int RallyPercentile(const BatchStats *stats, float percentile) {
+    long long rank = (long long)(percentile * stats->rallies);
+    long long seen = 0;
+
+    for (int i = 0; i < RALLY_HISTOGRAM_SIZE; ++i) {
+        seen += stats->rallyHistogram[i];
+        if (seen > rank) {
+            return i;
+        }
+    }
+
+    return RALLY_HISTOGRAM_SIZE - 1;
+}
+
@@ -0,0 +1,520 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ball_pool.h"
+#include "collision_batch.h"
+#include "pong_sim.h"
+#include "tick.h"
+
+// Simulation constants
+#define MATCH_TICKS_MAX (PONG_TICK_RATE * 60 * 30)
+#define DEFAULT_MATCHES 100
+
+// Landing check, every start on a grid of heights and angles against the ray walk
+#define LANDING_CHECK_ANGLE_MAX  75.0f // degrees from the horizontal
+#define LANDING_CHECK_ANGLE_STEP 0.25f
+#define LANDING_CHECK_TOLERANCE  0.5f // pixels
+
+// Tunneling check, random shots at still paddles for every speed and step length
+#define CCD_CHECK_SHOTS     20000
+#define CCD_CHECK_TICKS_MAX 1000
+#define CCD_CHECK_TOLERANCE 0.01f // pixels the ball may end up inside a wall
+
+// SIMD check, random batches through every vector path against SweptAABB. An odd
+// mover count leaves every path a tail for the narrower ones.
+#define SIMD_CHECK_ROUNDS  2000
+#define SIMD_CHECK_MOVERS  37
+#define SIMD_CHECK_TARGETS 8
+#define SIMD_CHECK_PAIRS   (SIMD_CHECK_MOVERS * SIMD_CHECK_TARGETS)
+
+static const char *difficultyNames[IA_DIFFICULTY_COUNT] = {"easy", "medium", "hard"};
+static const float ccdSpeeds[] = {10.0f, 25.0f, 50.0f, 100.0f}; // times the serve
+static const float ccdSteps[] = {PONG_TICK_DT, 1.0f / 30.0f};   // seconds
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+int CheckLanding(void);
+int CheckTunneling(void);
+int CheckSimd(void);
+float RandomFloat(PongState *dice, float min, float max);
+float RectOverlap(Rectangle rect1, Rectangle rect2);
+bool SameSweptResult(const SweptResults *a, const SweptResults *b, int i);
+
+// -------------------------------------------------------------------------------------
+// Entrypoint
+// -------------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+    int matches = DEFAULT_MATCHES;
+    unsigned int seed = 1;
+    float dt = PONG_TICK_DT;
+    int balls = 0;
+    bool arena = false;
+    IADifficulty difficulty = IA_HARD;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--matches") == 0 && i + 1 < argc) {
+            matches = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--dt") == 0 && i + 1 < argc) {
+            dt = strtof(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--balls") == 0 && i + 1 < argc) {
+            balls = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--bricks") == 0) {
+            arena = true;
+        } else if (strcmp(argv[i], "--difficulty") == 0 && i + 1 < argc) {
+            ++i;
+            for (int d = 0; d < IA_DIFFICULTY_COUNT; ++d) {
+                if (strcmp(argv[i], difficultyNames[d]) == 0) {
+                    difficulty = d;
+                }
+            }
+        } else if (strcmp(argv[i], "--check-landing") == 0) {
+            return CheckLanding();
+        } else if (strcmp(argv[i], "--check-ccd") == 0) {
+            return CheckTunneling();
+        } else if (strcmp(argv[i], "--check-simd") == 0) {
+            return CheckSimd();
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--matches N] [--seed S] [--dt SECONDS] [--balls N]\n"
+                    "          [--bricks] [--difficulty easy|medium|hard]\n"
+                    "       %s --check-landing | --check-ccd | --check-simd\n",
+                    argv[0], argv[0]);
+            return 1;
+        }
+    }
+
+    PongState state;
+    PongInput input = {0};
+    BallPool pool = CreateBallPool(balls > 0 ? balls : 1, seed);
+    if (pool.capacity == 0) {
+        fprintf(stderr, "can't allocate %d balls\n", balls);
+        return 1;
+    }
+    long long ballHits = 0, brickHits = 0;
+    BrickGrid grid = {0};
+    if (arena) {
+        grid = CreateBrickGrid(ARENA_AREA, ARENA_BRICK_WIDTH, ARENA_BRICK_HEIGHT,
+                               ARENA_BRICK_GAP, ARENA_CELL_SIZE);
+        if (grid.brickCount == 0) {
+            fprintf(stderr, "can't allocate the bricks\n");
+            DestroyBallPool(&pool);
+            return 1;
+        }
+    }
+    BrickGrid *bricks = arena ? &grid : NULL;
+    long long totalTicks = 0;
+    int leftWins = 0, rightWins = 0, unfinished = 0;
+
+    double start = GetSeconds();
+    for (int match = 0; match < matches; ++match) {
+        PongInit(&state, seed + match, CONTROL_IA, CONTROL_IA);
+        PongSetDifficulty(&state, difficulty, IA_HARD);
+        pool.count = 0;
+        SpawnBalls(&pool, balls);
+        if (bricks != NULL) {
+            ResetBrickGrid(bricks);
+        }
+
+        int ticks = 0;
+        while (!PongIsOver(&state) && ticks < MATCH_TICKS_MAX) {
+            int alive = arena ? grid.aliveCount : 0;
+            PongStepBricks(&state, input, dt, bricks);
+            if (pool.count > 0) {
+                ballHits += UpdateBallPool(&pool, &state, bricks, dt);
+            }
+            if (bricks != NULL) {
+                brickHits += alive - grid.aliveCount;
+                if (grid.aliveCount == 0) {
+                    ResetBrickGrid(bricks);
+                }
+            }
+            ++ticks;
+        }
+
+        totalTicks += ticks;
+        if (!PongIsOver(&state)) {
+            ++unfinished;
+        } else if (state.leftScore > state.rightScore) {
+            ++leftWins;
+        } else {
+            ++rightWins;
+        }
+    }
+    double elapsed = GetSeconds() - start;
+    DestroyBallPool(&pool);
+
+    printf("matches:    %d (left %d, right %d, unfinished %d)\n", matches, leftWins,
+           rightWins, unfinished);
+    printf("difficulty: left %s, right hard\n", difficultyNames[difficulty]);
+    printf("ticks:      %lld\n", totalTicks);
+    if (balls > 0) {
+        printf("balls:      %d (%lld paddle hits)\n", balls, ballHits);
+    }
+    if (arena) {
+        printf("bricks:     %d (%lld destroyed)\n", grid.brickCount, brickHits);
+        DestroyBrickGrid(&grid);
+    }
+    printf("elapsed:    %.3f s\n", elapsed);
+    printf("ticks/s:    %.0f\n", elapsed > 0.0 ? totalTicks / elapsed : 0.0);
+
+    return 0;
+}
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+int CheckLanding(void) {
+    // the closed form prediction against the exact walk of the ray through its
+    // bounces, from both paddle lines and the serve, in both directions. make bench
+    // times the two.
+    Vector2 starts[BOUNCE_POINTS_MAX], ends[BOUNCE_POINTS_MAX];
+    GetBounceLines(starts, ends);
+    float lineX[3] = {starts[3].x, (SCREEN_WIDTH - BALL_WIDTH) / 2.0f, starts[1].x};
+    float top = starts[0].y, bottom = starts[2].y;
+
+    Vector2 bouncePoints[BOUNCE_POINTS_MAX];
+    long long cases = 0, truncated = 0;
+    double errorSum = 0.0;
+    float errorMax = 0.0f;
+    Entity worst = {0};
+
+    float angleMax = LANDING_CHECK_ANGLE_MAX;
+    for (int x = 0; x < 3; ++x) {
+        for (float y = top; y <= bottom; y += 1.0f) {
+            for (float angle = -angleMax; angle <= angleMax;
+                 angle += LANDING_CHECK_ANGLE_STEP) {
+                for (int side = -1; side <= 1; side += 2) {
+                    float radians = angle * PI / 180.0f;
+                    Entity ball = {.rect = {lineX[x], y, BALL_WIDTH, BALL_HEIGHT},
+                                   .dir = {side * cosf(radians), sinf(radians)},
+                                   .speed = BALL_INITIAL_SPEED};
+                    float targetX = side > 0 ? starts[1].x : starts[3].x;
+                    if (ball.rect.x == targetX) {
+                        continue;
+                    }
+
+                    int count = CalculateBouncePoints(ball, bouncePoints);
+                    float predicted = PredictBallLanding(ball);
+
+                    // the walk gives up after BOUNCE_POINTS_MAX points
+                    if (fabsf(bouncePoints[count].x - targetX) > 0.01f) {
+                        ++truncated;
+                        continue;
+                    }
+                    float error = fabsf(bouncePoints[count].y - predicted);
+                    errorSum += error;
+                    if (error > errorMax) {
+                        errorMax = error;
+                        worst = ball;
+                    }
+                    ++cases;
+                }
+            }
+        }
+    }
+
+    printf("landing:    %lld starts (%lld past the ray walk bounce limit)\n", cases,
+           truncated);
+    printf("error:      mean %.4f px, max %.4f px (x %.0f, y %.1f, dir %.3f %.3f)\n",
+           cases > 0 ? errorSum / cases : 0.0, errorMax, worst.rect.x, worst.rect.y,
+           worst.dir.x, worst.dir.y);
+
+    // the miss each profile adds on purpose, at the serve and after 16 hits
+    float fastSpeed = BALL_INITIAL_SPEED + BALL_SPEED_INCREMENT * 4.0f;
+    for (int d = 0; d < IA_DIFFICULTY_COUNT; ++d) {
+        IAProfile profile = PongIAProfile(d);
+        printf("%-11s speed %.0f, response %.2f s, miss up to %.0f px (%.0f px after "
+               "16 hits)\n",
+               difficultyNames[d], profile.speed, profile.responseTime,
+               profile.aimError, profile.aimError * fastSpeed / BALL_INITIAL_SPEED);
+    }
+
+    return errorMax <= LANDING_CHECK_TOLERANCE ? 0 : 1;
+}
+
+int CheckTunneling(void) {
+    // the closed form landing tells the shots the paddle must send back from the ones
+    // that clear it by more than the ball moves up or down over the paddle width;
+    // shots between the two may clip a corner either way and only have to stay in.
+    // Every step the ball must stay between the borders and out of the paddles.
+    Vector2 starts[BOUNCE_POINTS_MAX], ends[BOUNCE_POINTS_MAX];
+    GetBounceLines(starts, ends);
+    float leftX = starts[3].x, rightX = starts[1].x;
+    int speedCount = sizeof(ccdSpeeds) / sizeof(float);
+    int stepCount = sizeof(ccdSteps) / sizeof(float);
+
+    PongState dice = {.rngState = 1};
+    PongState state;
+    PongInput input = {0};
+    long long shots = 0, returned = 0, missed = 0, grazing = 0;
+    long long throughPaddle = 0, throughBorder = 0, inside = 0, falseHits = 0;
+    long long stuck = 0;
+    Entity failed = {0};
+
+    for (int s = 0; s < speedCount; ++s) {
+        for (int d = 0; d < stepCount; ++d) {
+            for (int shot = 0; shot < CCD_CHECK_SHOTS; ++shot) {
+                PongInit(&state, 1, CONTROL_PLAYER, CONTROL_PLAYER);
+                float paddleMax = LIMIT_BOTTOM - PADDLE_HEIGHT;
+                state.leftPaddle.rect.y = RandomFloat(&dice, LIMIT_TOP, paddleMax);
+                state.rightPaddle.rect.y = RandomFloat(&dice, LIMIT_TOP, paddleMax);
+
+                float angle = RandomFloat(&dice, -LANDING_CHECK_ANGLE_MAX,
+                                          LANDING_CHECK_ANGLE_MAX) *
+                              PI / 180.0f;
+                float side = PongRandomValue(&dice, 0, 1) == 0 ? -1.0f : 1.0f;
+                Entity *ball = &state.ball;
+                ball->rect.x = RandomFloat(&dice, leftX + 1.0f, rightX - 1.0f);
+                ball->rect.y =
+                    RandomFloat(&dice, LIMIT_TOP, LIMIT_BOTTOM - BALL_HEIGHT);
+                ball->dir = (Vector2){side * cosf(angle), sinf(angle)};
+                ball->speed = ccdSpeeds[s] * BALL_INITIAL_SPEED;
+                Entity start = *ball;
+
+                // gap between the landing and the paddle, below zero they overlap
+                Rectangle paddle = side > 0 ? state.rightPaddle.rect
+                                            : state.leftPaddle.rect;
+                float landing = PredictBallLanding(*ball);
+                float gap = fmaxf(paddle.y - (landing + BALL_HEIGHT),
+                                  landing - (paddle.y + PADDLE_HEIGHT));
+                float reach =
+                    (PADDLE_WIDTH + BALL_WIDTH) * fabsf(ball->dir.y / ball->dir.x);
+                bool mustHit = gap < -LANDING_CHECK_TOLERANCE;
+                bool mustMiss = gap > reach + LANDING_CHECK_TOLERANCE;
+                unsigned int scoreEvent =
+                    side > 0 ? PONG_EVENT_SCORE_LEFT : PONG_EVENT_SCORE_RIGHT;
+
+                bool hit = false, scored = false, escaped = false;
+                for (int tick = 0; tick < CCD_CHECK_TICKS_MAX && !hit && !scored;
+                     ++tick) {
+                    PongStep(&state, input, ccdSteps[d]);
+                    hit = (state.events & PONG_EVENT_HIT) != 0;
+                    scored = (state.events & scoreEvent) != 0;
+
+                    // a ball that scored is back at the serve
+                    if (!scored &&
+                        (ball->rect.y < LIMIT_TOP - CCD_CHECK_TOLERANCE ||
+                         ball->rect.y + BALL_HEIGHT >
+                             LIMIT_BOTTOM + CCD_CHECK_TOLERANCE)) {
+                        ++throughBorder;
+                        escaped = true;
+                        break;
+                    }
+                    if (RectOverlap(ball->rect, state.leftPaddle.rect) >
+                            CCD_CHECK_TOLERANCE ||
+                        RectOverlap(ball->rect, state.rightPaddle.rect) >
+                            CCD_CHECK_TOLERANCE) {
+                        ++inside;
+                        escaped = true;
+                        break;
+                    }
+                }
+
+                bool sentBack = hit && ball->dir.x * side < 0.0f;
+                bool failure = escaped;
+                if (!escaped && !hit && !scored) {
+                    ++stuck;
+                    failure = true;
+                } else if (!escaped && mustHit && !sentBack) {
+                    ++throughPaddle;
+                    failure = true;
+                } else if (!escaped && mustMiss && hit) {
+                    ++falseHits;
+                    failure = true;
+                }
+                if (failure && failed.speed == 0.0f) {
+                    failed = start;
+                }
+
+                returned += mustHit;
+                missed += mustMiss;
+                grazing += !mustHit && !mustMiss;
+                ++shots;
+            }
+        }
+    }
+
+    long long failures = throughPaddle + throughBorder + inside + falseHits + stuck;
+    printf("ccd:        %lld shots at %.0fx to %.0fx the serve speed, %.0f and %.0f "
+           "steps/s\n",
+           shots, ccdSpeeds[0], ccdSpeeds[speedCount - 1], 1.0f / ccdSteps[0],
+           1.0f / ccdSteps[stepCount - 1]);
+    printf("shots:      %lld sent back, %lld missed, %lld grazing a corner\n",
+           returned, missed, grazing);
+    printf("tunneling:  %lld through a paddle, %lld through a border, %lld inside a "
+           "paddle\n",
+           throughPaddle, throughBorder, inside);
+    printf("other:      %lld false hits, %lld never reached a paddle\n", falseHits,
+           stuck);
+    if (failures > 0) {
+        printf("first:      x %.1f, y %.1f, dir %.3f %.3f, speed %.0f\n",
+               failed.rect.x, failed.rect.y, failed.dir.x, failed.dir.y,
+               failed.speed);
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+int CheckSimd(void) {
+    // movers anywhere around the targets, some with a signed zero velocity on an axis
+    // and some touching a target edge, where the slab divisions give infinities and
+    // NaNs. Every supported path has to match SweptAABB to the bit.
+    static float moverX[SIMD_CHECK_MOVERS], moverY[SIMD_CHECK_MOVERS];
+    static float moverWidth[SIMD_CHECK_MOVERS], moverHeight[SIMD_CHECK_MOVERS];
+    static float velX[SIMD_CHECK_MOVERS], velY[SIMD_CHECK_MOVERS];
+    static float targetX[SIMD_CHECK_TARGETS], targetY[SIMD_CHECK_TARGETS];
+    static float targetWidth[SIMD_CHECK_TARGETS], targetHeight[SIMD_CHECK_TARGETS];
+    static int hit[2][SIMD_CHECK_PAIRS];
+    static float hitTime[2][SIMD_CHECK_PAIRS];
+    static float contactX[2][SIMD_CHECK_PAIRS], contactY[2][SIMD_CHECK_PAIRS];
+    static float normalX[2][SIMD_CHECK_PAIRS], normalY[2][SIMD_CHECK_PAIRS];
+
+    SweptMovers movers = {.x = moverX,
+                          .y = moverY,
+                          .width = moverWidth,
+                          .height = moverHeight,
+                          .velX = velX,
+                          .velY = velY,
+                          .count = SIMD_CHECK_MOVERS};
+    SweptTargets targets = {.x = targetX,
+                            .y = targetY,
+                            .width = targetWidth,
+                            .height = targetHeight,
+                            .count = SIMD_CHECK_TARGETS};
+    SweptResults expected = {hit[0],      hitTime[0], contactX[0],
+                             contactY[0], normalX[0], normalY[0]};
+    SweptResults results = {hit[1],      hitTime[1], contactX[1],
+                            contactY[1], normalX[1], normalY[1]};
+
+    PongState dice = {.rngState = 1};
+    SimdLevel best = GetSimdLevel();
+    long long pairs = 0, mismatches[SIMD_COUNT] = {0};
+    int failedLevel = -1;
+    Rectangle failedRect = {0}, failedTarget = {0};
+    Vector2 failedVel = {0};
+
+    for (int round = 0; round < SIMD_CHECK_ROUNDS; ++round) {
+        for (int t = 0; t < SIMD_CHECK_TARGETS; ++t) {
+            targetX[t] = RandomFloat(&dice, 0.0f, SCREEN_WIDTH);
+            targetY[t] = RandomFloat(&dice, 0.0f, SCREEN_HEIGHT);
+            targetWidth[t] = RandomFloat(&dice, 1.0f, 100.0f);
+            targetHeight[t] = RandomFloat(&dice, 1.0f, 100.0f);
+        }
+        for (int m = 0; m < SIMD_CHECK_MOVERS; ++m) {
+            float speed = RandomFloat(&dice, 0.0f, 100.0f) * BALL_INITIAL_SPEED;
+            moverWidth[m] = RandomFloat(&dice, 1.0f, 40.0f);
+            moverHeight[m] = RandomFloat(&dice, 1.0f, 40.0f);
+            moverX[m] = RandomFloat(&dice, 0.0f, SCREEN_WIDTH);
+            moverY[m] = RandomFloat(&dice, 0.0f, SCREEN_HEIGHT);
+            velX[m] = RandomFloat(&dice, -speed, speed);
+            velY[m] = RandomFloat(&dice, -speed, speed);
+
+            // flush against a side of a target on either axis, or both at a corner
+            int t = PongRandomValue(&dice, 0, SIMD_CHECK_TARGETS - 1);
+            int sideX = PongRandomValue(&dice, 0, 3);
+            int sideY = PongRandomValue(&dice, 0, 3);
+            if (sideX == 0) {
+                moverX[m] = targetX[t] - moverWidth[m];
+            } else if (sideX == 1) {
+                moverX[m] = targetX[t] + targetWidth[t];
+            }
+            if (sideY == 0) {
+                moverY[m] = targetY[t] - moverHeight[m];
+            } else if (sideY == 1) {
+                moverY[m] = targetY[t] + targetHeight[t];
+            }
+
+            int still = PongRandomValue(&dice, 0, 5);
+            if (still < 2) {
+                velX[m] = still == 0 ? 0.0f : -0.0f;
+            } else if (still < 4) {
+                velY[m] = still == 2 ? 0.0f : -0.0f;
+            }
+        }
+
+        for (int t = 0; t < SIMD_CHECK_TARGETS; ++t) {
+            Rectangle target = {targetX[t], targetY[t], targetWidth[t],
+                                targetHeight[t]};
+            for (int m = 0; m < SIMD_CHECK_MOVERS; ++m) {
+                Rectangle rect = {moverX[m], moverY[m], moverWidth[m],
+                                  moverHeight[m]};
+                Vector2 vel = {velX[m], velY[m]};
+                CollisionData data = SweptAABB(rect, vel, target);
+                int i = t * SIMD_CHECK_MOVERS + m;
+                expected.hit[i] = data.hit;
+                expected.time[i] = data.time;
+                expected.contactX[i] = data.contactPoint.x;
+                expected.contactY[i] = data.contactPoint.y;
+                expected.normalX[i] = data.contactNormal.x;
+                expected.normalY[i] = data.contactNormal.y;
+            }
+        }
+
+        for (int level = SIMD_SCALAR; level <= (int)best; ++level) {
+            // poisoned first, a pair the path skips can't pass on the last results
+            memset(hit[1], 0xff, sizeof(hit[1]));
+            memset(hitTime[1], 0xff, sizeof(hitTime[1]));
+            SweptAABBBatchLevel(level, &movers, &targets, &results);
+
+            for (int i = 0; i < SIMD_CHECK_PAIRS; ++i) {
+                if (SameSweptResult(&expected, &results, i)) {
+                    continue;
+                }
+                if (failedLevel < 0) {
+                    int m = i % SIMD_CHECK_MOVERS, t = i / SIMD_CHECK_MOVERS;
+                    failedLevel = level;
+                    failedRect = (Rectangle){moverX[m], moverY[m], moverWidth[m],
+                                             moverHeight[m]};
+                    failedVel = (Vector2){velX[m], velY[m]};
+                    failedTarget = (Rectangle){targetX[t], targetY[t], targetWidth[t],
+                                               targetHeight[t]};
+                }
+                ++mismatches[level];
+            }
+        }
+        pairs += SIMD_CHECK_PAIRS;
+    }
+
+    printf("simd:       %lld pairs, %d movers against %d targets a batch\n", pairs,
+           SIMD_CHECK_MOVERS, SIMD_CHECK_TARGETS);
+    for (int level = SIMD_SCALAR; level <= (int)best; ++level) {
+        printf("%-11s %lld differ from SweptAABB\n", GetSimdLevelName(level),
+               mismatches[level]);
+    }
+    if (failedLevel >= 0) {
+        printf("first:      %s, mover %g %g %g %g, vel %g %g, target %g %g %g %g\n",
+               GetSimdLevelName(failedLevel), failedRect.x, failedRect.y,
+               failedRect.width, failedRect.height, failedVel.x, failedVel.y,
+               failedTarget.x, failedTarget.y, failedTarget.width, failedTarget.height);
+    }
+
+    return failedLevel < 0 ? 0 : 1;
+}
+
+float RandomFloat(PongState *dice, float min, float max) {
+    return min + PongRandomValue(dice, 0, 1000000) / 1000000.0f * (max - min);
+}
+
+float RectOverlap(Rectangle rect1, Rectangle rect2) {
+    // how deep they overlap on the shallower axis, negative when apart
+    float x = fminf(rect1.x + rect1.width, rect2.x + rect2.width) -
+              fmaxf(rect1.x, rect2.x);
+    float y = fminf(rect1.y + rect1.height, rect2.y + rect2.height) -
+              fmaxf(rect1.y, rect2.y);
+    return fminf(x, y);
+}
+
+bool SameSweptResult(const SweptResults *a, const SweptResults *b, int i) {
+    // bit for bit, so a sign of zero or a NaN payload counts
+    return a->hit[i] == b->hit[i] &&
+           memcmp(&a->time[i], &b->time[i], sizeof(float)) == 0 &&
+           memcmp(&a->contactX[i], &b->contactX[i], sizeof(float)) == 0 &&
+           memcmp(&a->contactY[i], &b->contactY[i], sizeof(float)) == 0 &&
+           memcmp(&a->normalX[i], &b->normalX[i], sizeof(float)) == 0 &&
+           memcmp(&a->normalY[i], &b->normalY[i], sizeof(float)) == 0;
+}
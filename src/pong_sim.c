@@ -0,0 +1,558 @@
+#include "pong_sim.h"
+
+#include <math.h>
+#include <stddef.h>
+
+#include "brick_grid.h"
+#include "trace.h"
+
+#define RAYMATH_STATIC_INLINE
+#include <raymath.h>
+
+// Lines the ball top-left corner travels between, used by the bounce prediction
+static const Vector2 topSP = {LIMIT_LEFT + PADDLE_WIDTH, LIMIT_TOP};
+static const Vector2 topEP = {LIMIT_RIGHT - PADDLE_WIDTH - BALL_WIDTH, LIMIT_TOP};
+static const Vector2 rightSP = {LIMIT_RIGHT - PADDLE_WIDTH - BALL_WIDTH, LIMIT_TOP};
+static const Vector2 rightEP = {LIMIT_RIGHT - PADDLE_WIDTH - BALL_WIDTH,
+                                LIMIT_BOTTOM - BALL_HEIGHT};
+static const Vector2 bottomSP = {LIMIT_LEFT + PADDLE_WIDTH, LIMIT_BOTTOM - BALL_HEIGHT};
+static const Vector2 bottomEP = {LIMIT_RIGHT - PADDLE_WIDTH - BALL_WIDTH,
+                                 LIMIT_BOTTOM - BALL_HEIGHT};
+static const Vector2 leftSP = {LIMIT_LEFT + PADDLE_WIDTH, LIMIT_TOP};
+static const Vector2 leftEP = {LIMIT_LEFT + PADDLE_WIDTH, LIMIT_BOTTOM};
+
+// IA paddles per difficulty, the prediction is exact and the easier ones aim off it
+static const IAProfile iaProfiles[IA_DIFFICULTY_COUNT] = {
+    [IA_EASY] = {.speed = 300, .responseTime = 0.6f, .aimError = 60.0f},
+    [IA_MEDIUM] = {.speed = 350, .responseTime = 0.5f, .aimError = 25.0f},
+    [IA_HARD] = {.speed = PADDLE_IA_SPEED, .responseTime = 0.5f, .aimError = 0.0f}};
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static void UpdatePaddleIA(Entity *paddle, PaddleIA *ia, float dt) {
+    ia->timer += dt;
+    float paddleY = paddle->rect.y + ia->hitPos;
+    float paddlePosDiff = (ia->targetPos - paddleY > 0.0f) ? 1.0f : -1.0f;
+    float paddleFuturePos = paddle->speed * dt;
+
+    if (ia->timer > ia->responseTime) {
+        if (paddlePosDiff > 0.0f && paddleY + paddleFuturePos > ia->targetPos) {
+            paddle->rect.y = ia->targetPos - ia->hitPos;
+        } else if (paddlePosDiff < 0.0f && paddleY - paddleFuturePos < ia->targetPos) {
+            paddle->rect.y = ia->targetPos - ia->hitPos;
+        } else {
+            paddle->rect.y += paddlePosDiff * paddleFuturePos;
+        }
+    }
+}
+
+static float AimBallLanding(PongState *state, const PaddleIA *ia, Entity ball) {
+    // a miss up to the aim error, growing with the ball speed. Exact aim draws
+    // nothing from the match random state, so its matches replay as they were.
+    float landing = PredictBallLanding(ball);
+    if (ia->aimError > 0.0f) {
+        float miss = PongRandomValue(state, -1000, 1000) / 1000.0f;
+        landing += miss * ia->aimError * ball.speed / BALL_INITIAL_SPEED;
+    }
+    return landing;
+}
+
+static void BounceBallPaddle(Entity *ball, Entity paddle, CollisionData collData) {
+    ball->rect.x = collData.contactPoint.x;
+    ball->rect.y = collData.contactPoint.y;
+
+    if (collData.contactNormal.x == 0) {
+        // colided from top or bottom
+        ball->dir.y *= -1.0f;
+    } else {
+        // collided from the front
+        ball->dir.x *= -1.0f;
+        ball->dir.y = (2 * (ball->rect.y - paddle.rect.y + ball->rect.height) /
+                       (PADDLE_HEIGHT + ball->rect.height)) -
+                      1.0f;
+        ball->dir = Vector2Normalize(ball->dir);
+    }
+}
+
+static void BounceBallBrick(Entity *ball, struct BrickGrid *bricks, int brick,
+                            CollisionData collData) {
+    ball->rect.x = collData.contactPoint.x;
+    ball->rect.y = collData.contactPoint.y;
+    if (collData.contactNormal.x == 0) {
+        ball->dir.y *= -1.0f;
+    } else {
+        ball->dir.x *= -1.0f;
+    }
+    RemoveBrick(bricks, brick);
+}
+
+static void PaddleHit(PongState *state, bool hitRightPaddle) {
+    // the paddle that has not hit the ball goes to where it will land
+    Entity *ball = &state->ball;
+    PaddleIA *receiver = hitRightPaddle ? &state->leftIA : &state->rightIA;
+    PaddleIA *hitter = hitRightPaddle ? &state->rightIA : &state->leftIA;
+
+    receiver->targetPos = AimBallLanding(state, receiver, *ball);
+    receiver->hitPos = PongRandomValue(state, 0, 1000) / 1000.0f * PADDLE_HEIGHT;
+    hitter->targetPos = PongRandomValue(state, 0, SCREEN_HEIGHT);
+    hitter->hitPos = 0.0f;
+
+    // speed up ball
+    ball->speed =
+        BALL_INITIAL_SPEED + BALL_SPEED_INCREMENT * sqrtf(++state->hitCounter);
+
+    // reset timers for ia
+    receiver->timer = 0.0f;
+    hitter->timer = 0.0f;
+
+    state->events |= PONG_EVENT_HIT;
+}
+
+static void UpdatePaddle(Entity *paddle, PaddleControl control, PaddleIA *ia,
+                         float move, float dt) {
+    if (control == CONTROL_IA) {
+        UpdatePaddleIA(paddle, ia, dt);
+    } else {
+        paddle->dir.y = move;
+        paddle->rect.y += paddle->dir.y * paddle->speed * dt;
+    }
+
+    // keep paddle on screen
+    if (paddle->rect.y < LIMIT_TOP) {
+        paddle->rect.y = LIMIT_TOP;
+    } else if (paddle->rect.y + paddle->rect.height > LIMIT_BOTTOM) {
+        paddle->rect.y = LIMIT_BOTTOM - paddle->rect.height;
+    }
+}
+
+void PongInit(PongState *state, unsigned int seed, PaddleControl leftControl,
+              PaddleControl rightControl) {
+    *state = (PongState){0};
+    state->rngState = seed != 0 ? seed : 0x9e3779b9u;
+    state->leftControl = leftControl;
+    state->rightControl = rightControl;
+
+    state->leftPaddle =
+        (Entity){.rect = (Rectangle){0, 0, PADDLE_WIDTH, PADDLE_HEIGHT},
+                 .dir = (Vector2){0},
+                 .speed = leftControl == CONTROL_IA ? PADDLE_IA_SPEED : PADDLE_SPEED};
+    state->rightPaddle = state->leftPaddle;
+    state->rightPaddle.speed =
+        rightControl == CONTROL_IA ? PADDLE_IA_SPEED : PADDLE_SPEED;
+    state->ball = (Entity){.rect = (Rectangle){0, 0, BALL_WIDTH, BALL_HEIGHT},
+                           .dir = (Vector2){0},
+                           .speed = BALL_INITIAL_SPEED};
+
+    // reset paddle positions
+    state->leftPaddle.rect.x = PADDLE_HOR_OFFSET;
+    state->leftPaddle.rect.y = (SCREEN_HEIGHT - PADDLE_HEIGHT) / 2.0f;
+    state->rightPaddle.rect.x = SCREEN_WIDTH - PADDLE_HOR_OFFSET - PADDLE_WIDTH;
+    state->rightPaddle.rect.y = state->leftPaddle.rect.y;
+
+    // IA
+    PaddleIA ia = {.targetPos = state->leftPaddle.rect.y,
+                   .hitPos = PADDLE_HEIGHT / 2.0f,
+                   .responseTime = 0.5f,
+                   .timer = 0.0f};
+    state->leftIA = ia;
+    state->rightIA = ia;
+
+    PongResetBall(state);
+}
+
+void PongStep(PongState *state, PongInput input, float dt) {
+    PongStepBricks(state, input, dt, NULL);
+}
+
+void PongStepBricks(PongState *state, PongInput input, float dt,
+                    struct BrickGrid *bricks) {
+    Entity *ball = &state->ball;
+    state->events = PONG_EVENT_NONE;
+
+    // update paddles
+    UpdatePaddle(&state->rightPaddle, state->rightControl, &state->rightIA,
+                 input.rightMove, dt);
+    UpdatePaddle(&state->leftPaddle, state->leftControl, &state->leftIA,
+                 input.leftMove, dt);
+
+    // update ball, it goes to the earliest impact along its way, bounces and carries
+    // on with the rest of the step, so no speed or step length gets it through a
+    // paddle or a border. Paddles win a tie, then bricks.
+    float remaining = 1.0f;
+    for (int impact = 0; impact < BALL_IMPACTS_MAX && remaining > 0.0f; ++impact) {
+        Vector2 ballVel = Vector2Scale(ball->dir, ball->speed * dt * remaining);
+        CollisionData left = SweepBallPaddle(ball->rect, state->leftPaddle, ballVel);
+        CollisionData right = SweepBallPaddle(ball->rect, state->rightPaddle, ballVel);
+        CollisionData brick = {.time = 1.0f};
+        int brickHit = -1;
+        if (bricks != NULL) {
+            brickHit = FindBrickHit(bricks, ball->rect, ballVel, &brick);
+        }
+        CollisionData border = SweepBallBorders(ball->rect, ballVel);
+
+        float time = fminf(fminf(ImpactTime(left), ImpactTime(right)),
+                           fminf(ImpactTime(brick), ImpactTime(border)));
+        if (time > 1.0f) {
+            ball->rect.x += ballVel.x;
+            ball->rect.y += ballVel.y;
+            break;
+        }
+
+        if (ImpactTime(left) == time || ImpactTime(right) == time) {
+            bool hitRightPaddle = ImpactTime(left) != time;
+            if (hitRightPaddle) {
+                BounceBallPaddle(ball, state->rightPaddle, right);
+            } else {
+                BounceBallPaddle(ball, state->leftPaddle, left);
+            }
+            PaddleHit(state, hitRightPaddle);
+        } else if (ImpactTime(brick) == time) {
+            // the ball changed its path, update where it will land
+            BounceBallBrick(ball, bricks, brickHit, brick);
+            PaddleIA *receiver = ball->dir.x < 0.0f ? &state->leftIA : &state->rightIA;
+            receiver->targetPos = AimBallLanding(state, receiver, *ball);
+            state->events |= PONG_EVENT_BRICK;
+        } else {
+            // reflect ball screen border
+            ball->rect.x = border.contactPoint.x;
+            ball->rect.y = border.contactPoint.y;
+            ball->dir.y *= -1.0f;
+        }
+        remaining *= 1.0f - time;
+    }
+
+    if (ball->rect.x + ball->rect.width < 0.0f) {
+        PongResetBall(state);
+        ++state->rightScore;
+        state->events |= PONG_EVENT_SCORE_RIGHT;
+    } else if (ball->rect.x > SCREEN_WIDTH) {
+        PongResetBall(state);
+        ++state->leftScore;
+        state->events |= PONG_EVENT_SCORE_LEFT;
+    }
+
+    if (PongIsOver(state)) {
+        state->events |= PONG_EVENT_GAME_OVER;
+    }
+}
+
+void PongResetBall(PongState *state) {
+    Entity *ball = &state->ball;
+
+    state->hitCounter = 0;
+    ball->speed = BALL_INITIAL_SPEED;
+
+    ball->rect.x = (SCREEN_WIDTH - ball->rect.width) / 2.0f;
+    ball->rect.y = (SCREEN_HEIGHT - ball->rect.height) / 2.0f;
+    ball->dir.x = PongRandomValue(state, 0, 1) == 0 ? -1.0f : 1.0f;
+    ball->dir.y = PongRandomValue(state, 0, 1000) / 1000.0f;
+    ball->dir = Vector2Normalize(ball->dir);
+
+    PaddleIA *receiver = ball->dir.x < 0.0f ? &state->leftIA : &state->rightIA;
+    receiver->targetPos = AimBallLanding(state, receiver, *ball);
+}
+
+void PongSetDifficulty(PongState *state, IADifficulty left, IADifficulty right) {
+    // the IA paddles only, before the first step of the match
+    Entity *paddles[2] = {&state->leftPaddle, &state->rightPaddle};
+    PaddleIA *ias[2] = {&state->leftIA, &state->rightIA};
+    PaddleControl controls[2] = {state->leftControl, state->rightControl};
+    IADifficulty difficulties[2] = {left, right};
+
+    for (int i = 0; i < 2; ++i) {
+        IAProfile profile = PongIAProfile(difficulties[i]);
+        if (controls[i] == CONTROL_IA) {
+            paddles[i]->speed = profile.speed;
+            ias[i]->responseTime = profile.responseTime;
+            ias[i]->aimError = profile.aimError;
+        }
+    }
+
+    // the first serve was aimed exactly by PongInit
+    Entity *ball = &state->ball;
+    PaddleIA *receiver = ball->dir.x < 0.0f ? &state->leftIA : &state->rightIA;
+    receiver->targetPos = AimBallLanding(state, receiver, *ball);
+}
+
+IAProfile PongIAProfile(IADifficulty difficulty) {
+    return iaProfiles[difficulty < IA_DIFFICULTY_COUNT ? difficulty : IA_HARD];
+}
+
+bool PongIsOver(const PongState *state) {
+    return state->leftScore >= SCORE_MAX || state->rightScore >= SCORE_MAX;
+}
+
+int PongRandomValue(PongState *state, int min, int max) {
+    // xorshift32, kept in the state so matches are reproducible from the seed
+    unsigned int x = state->rngState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state->rngState = x;
+
+    return min + (int)(x % (unsigned int)(max - min + 1));
+}
+
+bool ResolveCollBallPaddle(Entity *ball, Entity paddle, Vector2 ballVel) {
+    TRACE_BEGIN("ResolveCollBallPaddle");
+    CollisionData collData = SweepBallPaddle(ball->rect, paddle, ballVel);
+
+    if (collData.hit) {
+        BounceBallPaddle(ball, paddle, collData);
+    }
+
+    TRACE_END();
+    return collData.hit;
+}
+
+bool ResolveCollBallBricks(Entity *ball, struct BrickGrid *bricks, Vector2 ballVel) {
+    CollisionData collData;
+    int brick = FindBrickHit(bricks, ball->rect, ballVel, &collData);
+
+    if (brick < 0) {
+        return false;
+    }
+
+    BounceBallBrick(ball, bricks, brick, collData);
+    return true;
+}
+
+float PredictBallLanding(Entity ball) {
+    // paddle line the ball top-left corner is heading to
+    float targetX = ball.dir.x > 0.0f ? rightSP.x : leftSP.x;
+    if (ball.dir.x == 0.0f) {
+        return ball.rect.y;
+    }
+
+    // follow the ray as if the top and bottom borders were not there
+    float time = fmaxf((targetX - ball.rect.x) / ball.dir.x, 0.0f);
+    float y = ball.rect.y + ball.dir.y * time - topSP.y;
+
+    // every reflection mirrors the arena, so fold the unbounded y back into it
+    float height = bottomSP.y - topSP.y;
+    float folded = fmodf(y, 2.0f * height);
+    if (folded < 0.0f) {
+        folded += 2.0f * height;
+    }
+    if (folded > height) {
+        folded = 2.0f * height - folded;
+    }
+
+    return topSP.y + folded;
+}
+
+int CalculateBouncePoints(Entity ball, Vector2 *bouncePoints) {
+    Vector2 curDir, hitPoint;
+    bool hitTop, hitRight, hitBottom, hitLeft;
+    float hitTime;
+    int count;
+
+    TRACE_BEGIN("CalculateBouncePoints");
+
+    // the first point is where the ball is
+    count = 0;
+    bouncePoints[0] = (Vector2){ball.rect.x, ball.rect.y};
+    curDir = ball.dir;
+
+    while (count < BOUNCE_POINTS_MAX - 1) {
+        // check top bounce
+        if (curDir.y < 0.0f) {
+            hitTop = RayIntersectLine(bouncePoints[count], curDir, topSP, topEP,
+                                      &hitPoint, &hitTime);
+            if (hitTop) {
+                curDir = Vector2Reflect(curDir, (Vector2){0.0f, 1.0f});
+                bouncePoints[++count] = hitPoint;
+                continue;
+            }
+        }
+
+        if (curDir.x > 0.0f) {
+            hitRight = RayIntersectLine(bouncePoints[count], curDir, rightSP, rightEP,
+                                        &hitPoint, &hitTime);
+            if (hitRight) {
+                curDir = Vector2Reflect(curDir, (Vector2){-1.0f, 0.0f});
+                bouncePoints[++count] = hitPoint;
+                break;
+            }
+        }
+
+        // check bottom bounce
+        if (curDir.y > 0.0f) {
+            hitBottom = RayIntersectLine(bouncePoints[count], curDir, bottomSP,
+                                         bottomEP, &hitPoint, &hitTime);
+            if (hitBottom) {
+                curDir = Vector2Reflect(curDir, (Vector2){0.0f, -1.0f});
+                bouncePoints[++count] = hitPoint;
+                continue;
+            }
+        }
+
+        if (curDir.x < 0.0f) {
+            hitLeft = RayIntersectLine(bouncePoints[count], curDir, leftSP, leftEP,
+                                       &hitPoint, &hitTime);
+            if (hitLeft) {
+                curDir = Vector2Reflect(curDir, (Vector2){1.0f, 0.0f});
+                bouncePoints[++count] = hitPoint;
+                break;
+            }
+        }
+
+        // we can break if don't reach any of the above
+        break;
+    }
+
+    TRACE_END();
+    return count;
+}
+
+void GetBounceLines(Vector2 *startPoints, Vector2 *endPoints) {
+    startPoints[0] = topSP;
+    startPoints[1] = rightSP;
+    startPoints[2] = bottomSP;
+    startPoints[3] = leftSP;
+    endPoints[0] = topEP;
+    endPoints[1] = rightEP;
+    endPoints[2] = bottomEP;
+    endPoints[3] = leftEP;
+}
+
+bool RayIntersectLine(Vector2 rayOrigin, Vector2 rayDir, Vector2 lineStart,
+                      Vector2 lineEnd, Vector2 *collPoint, float *collTime) {
+    Vector2 a = rayOrigin, r = rayDir;
+    Vector2 c = lineStart, s = Vector2Subtract(lineEnd, lineStart);
+
+    float rCrossS = Vector2CrossProduct(r, s);
+    if (FloatEquals(rCrossS, 0.0f)) {
+        return false;
+    }
+
+    float t1 = Vector2CrossProduct(Vector2Subtract(c, a), s) / rCrossS;
+    float t2 = Vector2CrossProduct(Vector2Subtract(c, a), r) / rCrossS;
+
+    if (t1 >= 0.0f && (0.0f <= t2 && t2 <= 1.0f)) {
+        *collPoint = Vector2Add(a, Vector2Scale(r, t1));
+        *collTime = t1;
+        return true;
+    }
+
+    return false;
+}
+
+float Vector2CrossProduct(Vector2 v1, Vector2 v2) { return v1.x * v2.y - v1.y * v2.x; }
+
+CollisionData SweepBallPaddle(Rectangle ball, Entity paddle, Vector2 ballVel) {
+    // the broad check first, SweptAABB alone hits along an axis the ball doesn't move
+    CollisionData collData = {.time = 1.0f};
+    if (AABBCheck(SweptRectangle(ball, ballVel), paddle.rect)) {
+        collData = SweptAABB(ball, ballVel, paddle.rect);
+    }
+    return collData;
+}
+
+CollisionData SweepBallBorders(Rectangle ball, Vector2 ballVel) {
+    // the border the ball is heading to, it bounces at once if already past it
+    CollisionData collData = {.time = 1.0f};
+    if (ballVel.y == 0.0f) {
+        return collData;
+    }
+
+    float limit = ballVel.y < 0.0f ? LIMIT_TOP : LIMIT_BOTTOM - ball.height;
+    float time = fmaxf((limit - ball.y) / ballVel.y, 0.0f);
+    if (time <= 1.0f) {
+        collData.hit = true;
+        collData.time = time;
+        collData.contactPoint = (Vector2){ball.x + ballVel.x * time, limit};
+        collData.contactNormal = (Vector2){0.0f, ballVel.y < 0.0f ? 1.0f : -1.0f};
+    }
+    return collData;
+}
+
+float ImpactTime(CollisionData collData) {
+    // a miss never comes first, the earliest impact is the smallest time
+    return collData.hit ? collData.time : INFINITY;
+}
+
+bool AABBCheck(Rectangle rect1, Rectangle rect2) {
+    return !(rect1.x + rect1.width < rect2.x || rect1.x > rect2.x + rect2.width ||
+             rect1.y + rect1.height < rect2.y || rect1.y > rect2.y + rect2.height);
+}
+
+Rectangle SweptRectangle(Rectangle rect, Vector2 vel) {
+    Rectangle sweptRect = {
+        .x = vel.x > 0.0f ? rect.x : rect.x + vel.x,
+        .y = vel.y > 0.0f ? rect.y : rect.y + vel.y,
+        .width = vel.x > 0.0f ? rect.width + vel.x : rect.width - vel.x,
+        .height = vel.y > 0.0f ? rect.height + vel.y : rect.height - vel.y};
+
+    return sweptRect;
+}
+
+CollisionData SweptAABB(Rectangle rect, Vector2 vel, Rectangle target) {
+    CollisionData data;
+    Vector2 invEntry, entry, invExit, exit;
+    float entryTime, exitTime;
+
+    // initialize data with no collision
+    data.hit = false;
+    data.time = 1.0f;
+    data.contactPoint = Vector2Zero();
+    data.contactNormal = Vector2Zero();
+
+    // find the distance between the objects on the near and far sides for both
+    // x and y
+    if (vel.x > 0.0f) {
+        invEntry.x = target.x - (rect.x + rect.width);
+        invExit.x = (target.x + target.width) - rect.x;
+    } else {
+        invEntry.x = (target.x + target.width) - rect.x;
+        invExit.x = target.x - (rect.x + rect.width);
+    }
+
+    if (vel.y > 0.0f) {
+        invEntry.y = target.y - (rect.y + rect.height);
+        invExit.y = (target.y + target.height) - rect.y;
+    } else {
+        invEntry.y = (target.y + target.height) - rect.y;
+        invExit.y = target.y - (rect.y + rect.height);
+    }
+
+    // find time of collision and time of leaving for each axis
+    entry = (Vector2){-INFINITY, -INFINITY};
+    exit = (Vector2){INFINITY, INFINITY};
+
+    if (vel.x != 0) {
+        entry.x = invEntry.x / vel.x;
+        exit.x = invExit.x / vel.x;
+    }
+
+    if (vel.y != 0) {
+        entry.y = invEntry.y / vel.y;
+        exit.y = invExit.y / vel.y;
+    }
+
+    entryTime = fmaxf(entry.x, entry.y);
+    exitTime = fminf(exit.x, exit.y);
+
+    if (entryTime > exitTime || (entry.x < 0.0f && entry.y < 0.0f) || entry.x > 1.0f ||
+        entry.y > 1.0f) {
+        // no collision
+        return data;
+    }
+
+    // calculate normal
+    if (entry.x > entry.y) {
+        data.contactNormal.x = invEntry.x < 0.0f ? 1.0f : -1.0f;
+    } else {
+        data.contactNormal.y = invEntry.y < 0.0f ? 1.0f : -1.0f;
+    }
+
+    // calculate contact point
+    data.contactPoint.x = rect.x + vel.x * entryTime;
+    data.contactPoint.y = rect.y + vel.y * entryTime;
+
+    data.hit = true;
+    data.time = entryTime;
+
+    return data;
+}
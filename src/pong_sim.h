@@ -0,0 +1,147 @@
+#ifndef PONG_SIM_H
+#define PONG_SIM_H
+
+#include <raylib.h>
+#include <stdbool.h>
+
+// Arena constants
+#define SCREEN_WIDTH  800
+#define SCREEN_HEIGHT 600
+
+// Dimensions
+#define PADDLE_WIDTH      15
+#define PADDLE_HEIGHT     80
+#define PADDLE_SPEED      600
+#define PADDLE_IA_SPEED   400
+#define PADDLE_HOR_OFFSET 30
+
+// Ball constants
+#define BALL_WIDTH           15
+#define BALL_HEIGHT          15
+#define BALL_INITIAL_SPEED   400
+#define BALL_SPEED_INCREMENT 100
+
+// Impacts a ball bounces off in one step, the motion left after the last is dropped
+#define BALL_IMPACTS_MAX 8
+
+// Limits for paddles and ball
+#define BORDER_WIDTH 15
+#define LIMIT_TOP    BORDER_WIDTH
+#define LIMIT_RIGHT  (SCREEN_WIDTH - PADDLE_HOR_OFFSET)
+#define LIMIT_BOTTOM (SCREEN_HEIGHT - BORDER_WIDTH)
+#define LIMIT_LEFT   PADDLE_HOR_OFFSET
+
+// How many bouncing points the debug overlay can draw
+#define BOUNCE_POINTS_MAX 20
+
+// Fixed simulation rate
+#define PONG_TICK_RATE 240
+#define PONG_TICK_DT   (1.0f / PONG_TICK_RATE)
+
+// Score that ends the match
+#define SCORE_MAX 10
+
+// -------------------------------------------------------------------------------------
+// Enumerations
+// -------------------------------------------------------------------------------------
+typedef enum {
+    CONTROL_PLAYER = 0,
+    CONTROL_IA
+} PaddleControl;
+
+// Skill of the IA paddles, hard is how they have always played
+typedef enum {
+    IA_EASY = 0,
+    IA_MEDIUM,
+    IA_HARD,
+    IA_DIFFICULTY_COUNT
+} IADifficulty;
+
+// Events raised by the last PongStep, used by the frontend for sound and screens
+typedef enum {
+    PONG_EVENT_NONE = 0,
+    PONG_EVENT_HIT = 1 << 0,
+    PONG_EVENT_SCORE_LEFT = 1 << 1,
+    PONG_EVENT_SCORE_RIGHT = 1 << 2,
+    PONG_EVENT_GAME_OVER = 1 << 3,
+    PONG_EVENT_BRICK = 1 << 4
+} PongEvent;
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+typedef struct Entity {
+    Rectangle rect; // position and dimensions
+    Vector2 dir;    // normilized direction
+    float speed;    // velocity multiplier
+} Entity;
+
+typedef struct CollisionData {
+    bool hit;              // true if collision has happened
+    float time;            // time for collision [0.0,1.0]
+    Vector2 contactPoint;  // collision point for restitution
+    Vector2 contactNormal; // surface normal where collide
+} CollisionData;
+
+typedef struct PaddleIA {
+    float targetPos;    // where the ball is expected to arrive
+    float hitPos;       // offset from the paddle top used to hit the ball
+    float responseTime; // delay before reacting to a new target
+    float timer;        // time since the target has changed
+    float aimError;     // largest miss of the target, at the initial ball speed
+} PaddleIA;
+
+typedef struct IAProfile {
+    float speed, responseTime, aimError;
+} IAProfile;
+
+typedef struct PongInput {
+    float leftMove;  // [-1.0,1.0], ignored when the left paddle is controlled by IA
+    float rightMove; // [-1.0,1.0], ignored when the right paddle is controlled by IA
+} PongInput;
+
+// The whole match, plain data so it can be copied, stored or stepped in parallel
+typedef struct PongState {
+    Entity leftPaddle, rightPaddle, ball;
+    PaddleControl leftControl, rightControl;
+    PaddleIA leftIA, rightIA;
+    int leftScore, rightScore;
+    int hitCounter;
+    unsigned int rngState;
+    unsigned int events; // PongEvent flags raised by the last step
+} PongState;
+
+struct BrickGrid;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+// Simulation
+void PongInit(PongState *state, unsigned int seed, PaddleControl leftControl,
+              PaddleControl rightControl);
+void PongStep(PongState *state, PongInput input, float dt);
+void PongStepBricks(PongState *state, PongInput input, float dt,
+                    struct BrickGrid *bricks);
+void PongResetBall(PongState *state);
+void PongSetDifficulty(PongState *state, IADifficulty left, IADifficulty right);
+IAProfile PongIAProfile(IADifficulty difficulty);
+bool PongIsOver(const PongState *state);
+int PongRandomValue(PongState *state, int min, int max);
+
+// Collision detection
+bool ResolveCollBallPaddle(Entity *ball, Entity paddle, Vector2 ballVel);
+bool ResolveCollBallBricks(Entity *ball, struct BrickGrid *bricks, Vector2 ballVel);
+float PredictBallLanding(Entity ball);
+int CalculateBouncePoints(Entity ball, Vector2 *bouncePoints);
+void GetBounceLines(Vector2 *startPoints, Vector2 *endPoints);
+bool RayIntersectLine(Vector2 rayOrigin, Vector2 rayDir, Vector2 lineStart,
+                      Vector2 lineEnd, Vector2 *collPoint, float *collTime);
+float Vector2CrossProduct(Vector2 v1, Vector2 v2);
+bool AABBCheck(Rectangle rect1, Rectangle rect2);
+Rectangle SweptRectangle(Rectangle rect, Vector2 vel);
+CollisionData SweptAABB(Rectangle rect, Vector2 vel, Rectangle target);
+CollisionData SweepBallPaddle(Rectangle ball, Entity paddle, Vector2 ballVel);
+CollisionData SweepBallBorders(Rectangle ball, Vector2 ballVel);
+float ImpactTime(CollisionData collData);
+
+#endif // PONG_SIM_H
@@ -0,0 +1,275 @@
+#include "raster.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Glyphs for ' ' to '_', five columns each, the lowest bit is the top row
+static const unsigned char rasterFont[64][RASTER_GLYPH_WIDTH] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5f, 0x00, 0x00},
+    {0x00, 0x07, 0x00, 0x07, 0x00}, {0x14, 0x7f, 0x14, 0x7f, 0x14},
+    {0x24, 0x2a, 0x7f, 0x2a, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62},
+    {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00},
+    {0x00, 0x1c, 0x22, 0x41, 0x00}, {0x00, 0x41, 0x22, 0x1c, 0x00},
+    {0x08, 0x2a, 0x1c, 0x2a, 0x08}, {0x08, 0x08, 0x3e, 0x08, 0x08},
+    {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08},
+    {0x00, 0x60, 0x60, 0x00, 0x00}, {0x20, 0x10, 0x08, 0x04, 0x02},
+    {0x3e, 0x51, 0x49, 0x45, 0x3e}, {0x00, 0x42, 0x7f, 0x40, 0x00},
+    {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4b, 0x31},
+    {0x18, 0x14, 0x12, 0x7f, 0x10}, {0x27, 0x45, 0x45, 0x45, 0x39},
+    {0x3c, 0x4a, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03},
+    {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1e},
+    {0x00, 0x36, 0x36, 0x00, 0x00}, {0x00, 0x56, 0x36, 0x00, 0x00},
+    {0x00, 0x08, 0x14, 0x22, 0x41}, {0x14, 0x14, 0x14, 0x14, 0x14},
+    {0x41, 0x22, 0x14, 0x08, 0x00}, {0x02, 0x01, 0x51, 0x09, 0x06},
+    {0x32, 0x49, 0x79, 0x41, 0x3e}, {0x7e, 0x11, 0x11, 0x11, 0x7e},
+    {0x7f, 0x49, 0x49, 0x49, 0x36}, {0x3e, 0x41, 0x41, 0x41, 0x22},
+    {0x7f, 0x41, 0x41, 0x22, 0x1c}, {0x7f, 0x49, 0x49, 0x49, 0x41},
+    {0x7f, 0x09, 0x09, 0x01, 0x01}, {0x3e, 0x41, 0x41, 0x51, 0x32},
+    {0x7f, 0x08, 0x08, 0x08, 0x7f}, {0x00, 0x41, 0x7f, 0x41, 0x00},
+    {0x20, 0x40, 0x41, 0x3f, 0x01}, {0x7f, 0x08, 0x14, 0x22, 0x41},
+    {0x7f, 0x40, 0x40, 0x40, 0x40}, {0x7f, 0x02, 0x04, 0x02, 0x7f},
+    {0x7f, 0x04, 0x08, 0x10, 0x7f}, {0x3e, 0x41, 0x41, 0x41, 0x3e},
+    {0x7f, 0x09, 0x09, 0x09, 0x06}, {0x3e, 0x41, 0x51, 0x21, 0x5e},
+    {0x7f, 0x09, 0x19, 0x29, 0x46}, {0x46, 0x49, 0x49, 0x49, 0x31},
+    {0x01, 0x01, 0x7f, 0x01, 0x01}, {0x3f, 0x40, 0x40, 0x40, 0x3f},
+    {0x1f, 0x20, 0x40, 0x20, 0x1f}, {0x7f, 0x20, 0x18, 0x20, 0x7f},
+    {0x63, 0x14, 0x08, 0x14, 0x63}, {0x03, 0x04, 0x78, 0x04, 0x03},
+    {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x00, 0x7f, 0x41, 0x41},
+    {0x02, 0x04, 0x08, 0x10, 0x20}, {0x41, 0x41, 0x7f, 0x00, 0x00},
+    {0x04, 0x02, 0x01, 0x02, 0x04}, {0x40, 0x40, 0x40, 0x40, 0x40}};
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static void FillSpan(Color *span, int count, Color color) {
+    if (color.a == 255 && count > 0) {
+        // copies of the already filled part, doubling each time
+        span[0] = color;
+        for (int filled = 1; filled < count; filled *= 2) {
+            int size = filled < count - filled ? filled : count - filled;
+            memcpy(&span[filled], span, size * sizeof(Color));
+        }
+        return;
+    }
+    if (color.a == 0) {
+        return;
+    }
+
+    // source over an opaque destination, which stays opaque
+    unsigned int a = color.a, na = 255 - color.a;
+    for (int i = 0; i < count; ++i) {
+        span[i].r = (color.r * a + span[i].r * na + 127) / 255;
+        span[i].g = (color.g * a + span[i].g * na + 127) / 255;
+        span[i].b = (color.b * a + span[i].b * na + 127) / 255;
+        span[i].a = 255;
+    }
+}
+
+static void FillRows(Raster *raster, int y0, int y1, int x0, int x1, Color color) {
+    x0 = x0 > 0 ? x0 : 0;
+    x1 = x1 < raster->width ? x1 : raster->width;
+    y0 = y0 > 0 ? y0 : 0;
+    y1 = y1 < raster->height ? y1 : raster->height;
+    for (int y = y0; y < y1 && x0 < x1; ++y) {
+        FillSpan(&raster->pixels[y * raster->width + x0], x1 - x0, color);
+    }
+}
+
+static int PixelEdge(float coordinate) {
+    // first pixel whose center is at or past the coordinate
+    return (int)ceilf(coordinate - 0.5f);
+}
+
+static void FillQuad(Raster *raster, const Vector2 *points, Color color) {
+    float minY = points[0].y, maxY = points[0].y;
+    for (int i = 1; i < 4; ++i) {
+        minY = fminf(minY, points[i].y);
+        maxY = fmaxf(maxY, points[i].y);
+    }
+
+    // convex, so every pixel row crosses two edges at most
+    int y1 = PixelEdge(maxY) < raster->height ? PixelEdge(maxY) : raster->height;
+    for (int y = PixelEdge(minY) > 0 ? PixelEdge(minY) : 0; y < y1; ++y) {
+        float center = y + 0.5f, left = INFINITY, right = -INFINITY;
+        for (int i = 0; i < 4; ++i) {
+            Vector2 a = points[i], b = points[(i + 1) % 4];
+            if ((a.y <= center) == (b.y <= center)) {
+                continue;
+            }
+            float x = a.x + (center - a.y) * (b.x - a.x) / (b.y - a.y);
+            left = fminf(left, x);
+            right = fmaxf(right, x);
+        }
+        if (left < right) {
+            FillRows(raster, y, y + 1, PixelEdge(left), PixelEdge(right), color);
+        }
+    }
+}
+
+static void BlendPixel(Raster *raster, int x, int y, Color color) {
+    if (x >= 0 && x < raster->width && y >= 0 && y < raster->height) {
+        FillSpan(&raster->pixels[y * raster->width + x], 1, color);
+    }
+}
+
+Raster CreateRaster(int width, int height) {
+    Raster raster = {0};
+    raster.pixels = calloc((size_t)width * height, sizeof(Color));
+    if (raster.pixels != NULL) {
+        raster.width = width;
+        raster.height = height;
+    }
+    return raster;
+}
+
+void DestroyRaster(Raster *raster) {
+    free(raster->pixels);
+    raster->pixels = NULL;
+    raster->width = 0;
+    raster->height = 0;
+}
+
+void RasterClear(Raster *raster, Color color) {
+    color.a = 255;
+    FillSpan(raster->pixels, raster->width * raster->height, color);
+}
+
+void RasterCopy(Raster *raster, const Raster *source) {
+    // same size only, a baked background under every frame
+    if (raster->width == source->width && raster->height == source->height) {
+        memcpy(raster->pixels, source->pixels,
+               (size_t)raster->width * raster->height * sizeof(Color));
+    }
+}
+
+void RasterRectangle(Raster *raster, Rectangle rect, Color color) {
+    FillRows(raster, PixelEdge(rect.y), PixelEdge(rect.y + rect.height),
+             PixelEdge(rect.x), PixelEdge(rect.x + rect.width), color);
+}
+
+void RasterRectangleLines(Raster *raster, Rectangle rect, float thick, Color color) {
+    // the same four rectangles raylib draws, the sides between top and bottom
+    float x = rect.x, y = rect.y, w = rect.width, h = rect.height;
+    RasterRectangle(raster, (Rectangle){x, y, w, thick}, color);
+    RasterRectangle(raster, (Rectangle){x, y + h - thick, w, thick}, color);
+    RasterRectangle(raster, (Rectangle){x, y + thick, thick, h - 2 * thick}, color);
+    RasterRectangle(raster, (Rectangle){x + w - thick, y + thick, thick, h - 2 * thick},
+                    color);
+}
+
+void RasterLine(Raster *raster, Vector2 start, Vector2 end, Color color) {
+    // one pixel per step along the major axis, the last pixel is left out like GL
+    int x0 = (int)floorf(start.x), y0 = (int)floorf(start.y);
+    int x1 = (int)floorf(end.x), y1 = (int)floorf(end.y);
+    int dx = abs(x1 - x0), dy = -abs(y1 - y0);
+    int sx = x0 < x1 ? 1 : -1, sy = y0 < y1 ? 1 : -1;
+    int error = dx + dy;
+
+    while (x0 != x1 || y0 != y1) {
+        BlendPixel(raster, x0, y0, color);
+        if (2 * error >= dy) {
+            error += dy;
+            x0 += sx;
+        }
+        if (2 * error <= dx) {
+            error += dx;
+            y0 += sy;
+        }
+    }
+}
+
+void RasterLineEx(Raster *raster, Vector2 start, Vector2 end, float thick,
+                  Color color) {
+    float dx = end.x - start.x, dy = end.y - start.y;
+    float length = sqrtf(dx * dx + dy * dy);
+    if (length == 0.0f) {
+        return;
+    }
+
+    // axis aligned lines, the usual case, are plain rectangles
+    float half = thick / 2.0f;
+    if (dx == 0.0f || dy == 0.0f) {
+        Rectangle rect = {fminf(start.x, end.x) - (dx == 0.0f ? half : 0.0f),
+                          fminf(start.y, end.y) - (dy == 0.0f ? half : 0.0f),
+                          dx == 0.0f ? thick : fabsf(dx),
+                          dy == 0.0f ? thick : fabsf(dy)};
+        RasterRectangle(raster, rect, color);
+        return;
+    }
+
+    Vector2 normal = {-dy / length * half, dx / length * half};
+    Vector2 points[4] = {{start.x + normal.x, start.y + normal.y},
+                         {end.x + normal.x, end.y + normal.y},
+                         {end.x - normal.x, end.y - normal.y},
+                         {start.x - normal.x, start.y - normal.y}};
+    FillQuad(raster, points, color);
+}
+
+void RasterText(Raster *raster, const char *text, float x, float y, int fontSize,
+                Color color) {
+    // every glyph pixel is a scaled square, runs of set pixels are filled at once
+    float scale = (float)(fontSize > RASTER_FONT_SIZE ? fontSize : RASTER_FONT_SIZE) /
+                  RASTER_FONT_SIZE;
+    for (const char *c = text; *c != '\0'; ++c, x += (RASTER_GLYPH_WIDTH + 1) * scale) {
+        int code = *c >= 'a' && *c <= 'z' ? *c - 'a' + 'A' : *c;
+        const unsigned char *glyph = rasterFont[code >= ' ' && code <= '_' ? code - ' '
+                                                                          : '?' - ' '];
+
+        for (int row = 0; row < RASTER_GLYPH_HEIGHT; ++row) {
+            float rowY = y + (row + 1) * scale;
+            for (int col = 0; col < RASTER_GLYPH_WIDTH; ++col) {
+                if (!(glyph[col] & (1 << row))) {
+                    continue;
+                }
+                int end = col;
+                while (end + 1 < RASTER_GLYPH_WIDTH && (glyph[end + 1] & (1 << row))) {
+                    ++end;
+                }
+                Rectangle run = {x + col * scale, rowY, (end - col + 1) * scale, scale};
+                RasterRectangle(raster, run, color);
+                col = end;
+            }
+        }
+    }
+}
+
+int RasterMeasureText(const char *text, int fontSize) {
+    float scale = (float)(fontSize > RASTER_FONT_SIZE ? fontSize : RASTER_FONT_SIZE) /
+                  RASTER_FONT_SIZE;
+    int count = 0;
+    for (const char *c = text; *c != '\0'; ++c) {
+        ++count;
+    }
+    return count > 0 ? (int)((count * (RASTER_GLYPH_WIDTH + 1) - 1) * scale) : 0;
+}
+
+unsigned long long RasterHash(const Raster *raster) {
+    // FNV-1a over whole pixels, packed the same way on any endianness
+    unsigned long long hash = 0xcbf29ce484222325ull;
+    for (int i = 0; i < raster->width * raster->height; ++i) {
+        Color pixel = raster->pixels[i];
+        hash ^= (unsigned int)pixel.r | (unsigned int)pixel.g << 8 |
+                (unsigned int)pixel.b << 16 | (unsigned int)pixel.a << 24;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+bool ExportRaster(const Raster *raster, const char *path) {
+    // binary PPM, any image viewer opens it and it needs no encoder
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+
+    fprintf(file, "P6\n%d %d\n255\n", raster->width, raster->height);
+    for (int i = 0; i < raster->width * raster->height; ++i) {
+        Color pixel = raster->pixels[i];
+        unsigned char rgb[3] = {pixel.r, pixel.g, pixel.b};
+        fwrite(rgb, 1, 3, file);
+    }
+
+    return fclose(file) == 0;
+}
@@ -0,0 +1,41 @@
+#ifndef RASTER_H
+#define RASTER_H
+
+#include <raylib.h>
+#include <stdbool.h>
+
+// Built-in font, 5x7 glyphs in a 10 pixel cell like the raylib default font
+#define RASTER_FONT_SIZE    10
+#define RASTER_GLYPH_WIDTH  5
+#define RASTER_GLYPH_HEIGHT 7
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+// CPU framebuffer, opaque RGBA pixels row by row. Shapes cover the pixels whose
+// center they contain and blend with the source alpha, the way the GPU path does
+// for axis aligned shapes. Nothing here needs a window or a GL context.
+typedef struct Raster {
+    Color *pixels;
+    int width, height;
+} Raster;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+Raster CreateRaster(int width, int height);
+void DestroyRaster(Raster *raster);
+void RasterClear(Raster *raster, Color color);
+void RasterCopy(Raster *raster, const Raster *source);
+void RasterRectangle(Raster *raster, Rectangle rect, Color color);
+void RasterRectangleLines(Raster *raster, Rectangle rect, float thick, Color color);
+void RasterLine(Raster *raster, Vector2 start, Vector2 end, Color color);
+void RasterLineEx(Raster *raster, Vector2 start, Vector2 end, float thick,
+                  Color color);
+void RasterText(Raster *raster, const char *text, float x, float y, int fontSize,
+                Color color);
+int RasterMeasureText(const char *text, int fontSize);
+unsigned long long RasterHash(const Raster *raster);
+bool ExportRaster(const Raster *raster, const char *path);
+
+#endif // RASTER_H
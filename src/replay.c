@@ -0,0 +1,194 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "replay.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifndef BUILD_HASH
+#define BUILD_HASH "unknown"
+#endif
+
+static const unsigned char replayMagic[4] = {'R', 'P', 'L', 'Y'};
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static void PutU16(unsigned char *bytes, unsigned int value) {
+    bytes[0] = value & 0xff;
+    bytes[1] = (value >> 8) & 0xff;
+}
+
+static void PutU32(unsigned char *bytes, unsigned int value) {
+    PutU16(bytes, value & 0xffff);
+    PutU16(bytes + 2, value >> 16);
+}
+
+static unsigned int GetU16(const unsigned char *bytes) {
+    return bytes[0] | (unsigned int)bytes[1] << 8;
+}
+
+static unsigned int GetU32(const unsigned char *bytes) {
+    return GetU16(bytes) | GetU16(bytes + 2) << 16;
+}
+
+static void WriteRun(Replay *replay) {
+    // ticks as a varint, 7 bits per byte with the high bit set on all but the last
+    unsigned char bytes[6];
+    int count = 0;
+    unsigned int ticks = replay->runLength;
+
+    bytes[count++] = replay->buttons;
+    do {
+        bytes[count] = ticks & 0x7f;
+        ticks >>= 7;
+        bytes[count++] |= ticks != 0 ? 0x80 : 0;
+    } while (ticks != 0);
+
+    fwrite(bytes, 1, count, replay->file);
+    replay->runLength = 0;
+}
+
+static bool ReadRun(Replay *replay) {
+    // a truncated run ends the replay, it was cut while recording
+    if (replay->offset >= replay->size) {
+        return false;
+    }
+    unsigned int buttons = replay->data[replay->offset++];
+
+    unsigned int ticks = 0;
+    for (int shift = 0;; shift += 7) {
+        if (replay->offset >= replay->size || shift > 28) {
+            return false;
+        }
+        unsigned char byte = replay->data[replay->offset++];
+        ticks |= (unsigned int)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+    }
+
+    replay->buttons = buttons;
+    replay->runLength = ticks;
+    return ticks > 0;
+}
+
+Replay CreateReplayRecorder(const char *path, ReplayGame game, unsigned int seed,
+                            unsigned int mode) {
+    Replay replay = {0};
+    replay.file = fopen(path, "wb");
+    if (replay.file == NULL) {
+        return replay;
+    }
+
+    replay.mode = REPLAY_RECORD;
+    replay.header.version = REPLAY_VERSION;
+    replay.header.game = game;
+    replay.header.seed = seed;
+    replay.header.mode = mode;
+    strncpy(replay.header.build, BUILD_HASH, REPLAY_BUILD_SIZE - 1);
+
+    unsigned char bytes[REPLAY_HEADER_SIZE] = {0};
+    memcpy(bytes, replayMagic, sizeof(replayMagic));
+    PutU16(bytes + 4, replay.header.version);
+    PutU16(bytes + 6, replay.header.game);
+    PutU32(bytes + 8, replay.header.seed);
+    PutU32(bytes + 12, replay.header.mode);
+    memcpy(bytes + 16, replay.header.build, REPLAY_BUILD_SIZE);
+    fwrite(bytes, 1, sizeof(bytes), replay.file);
+
+    return replay;
+}
+
+Replay CreateReplayPlayer(const char *path) {
+    Replay replay = {0};
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return replay;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < REPLAY_HEADER_SIZE) {
+        close(fd);
+        return replay;
+    }
+
+    // the mapping outlives the descriptor, pages are read in as playback reaches them
+    void *data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return replay;
+    }
+    posix_madvise(data, info.st_size, POSIX_MADV_SEQUENTIAL);
+
+    const unsigned char *bytes = data;
+    if (memcmp(bytes, replayMagic, sizeof(replayMagic)) != 0 ||
+        GetU16(bytes + 4) != REPLAY_VERSION) {
+        munmap(data, info.st_size);
+        return replay;
+    }
+
+    replay.mode = REPLAY_PLAY;
+    replay.header.version = GetU16(bytes + 4);
+    replay.header.game = GetU16(bytes + 6);
+    replay.header.seed = GetU32(bytes + 8);
+    replay.header.mode = GetU32(bytes + 12);
+    memcpy(replay.header.build, bytes + 16, REPLAY_BUILD_SIZE - 1);
+    replay.data = bytes;
+    replay.size = info.st_size;
+    replay.offset = REPLAY_HEADER_SIZE;
+
+    return replay;
+}
+
+void DestroyReplay(Replay *replay) {
+    if (replay->mode == REPLAY_RECORD) {
+        if (replay->runLength > 0) {
+            WriteRun(replay);
+        }
+        fclose(replay->file);
+    } else if (replay->mode == REPLAY_PLAY) {
+        munmap((void *)replay->data, replay->size);
+    }
+
+    // the header and tick count stay readable for reports
+    replay->mode = REPLAY_NONE;
+    replay->file = NULL;
+    replay->data = NULL;
+    replay->size = 0;
+}
+
+void ReplayWriteTick(Replay *replay, unsigned int buttons) {
+    if (replay->mode != REPLAY_RECORD) {
+        return;
+    }
+
+    buttons &= 0xff;
+    if (replay->runLength > 0 && buttons != replay->buttons) {
+        WriteRun(replay);
+    }
+    replay->buttons = buttons;
+    ++replay->runLength;
+    ++replay->ticks;
+}
+
+bool ReplayReadTick(Replay *replay, unsigned int *buttons) {
+    if (replay->mode != REPLAY_PLAY) {
+        return false;
+    }
+
+    if (replay->runLength == 0 && !ReadRun(replay)) {
+        return false;
+    }
+    --replay->runLength;
+    ++replay->ticks;
+    *buttons = replay->buttons;
+    return true;
+}
+
+bool ReplayMatchesBuild(const Replay *replay) {
+    return strncmp(replay->header.build, BUILD_HASH, REPLAY_BUILD_SIZE - 1) == 0;
+}
@@ -0,0 +1,64 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// File layout, all integers little endian:
+//   header  magic "RPLY", u16 version, u16 game, u32 seed, u32 mode, char build[16]
+//   runs    u8 buttons, varint ticks; repeated until the end of the file
+#define REPLAY_VERSION     1
+#define REPLAY_BUILD_SIZE  16
+#define REPLAY_HEADER_SIZE (16 + REPLAY_BUILD_SIZE)
+
+// -------------------------------------------------------------------------------------
+// Enumerations
+// -------------------------------------------------------------------------------------
+typedef enum {
+    REPLAY_GAME_PONG = 1,
+    REPLAY_GAME_SNAKE
+} ReplayGame;
+
+typedef enum {
+    REPLAY_NONE = 0,
+    REPLAY_RECORD,
+    REPLAY_PLAY
+} ReplayMode;
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+typedef struct ReplayHeader {
+    unsigned int version;
+    ReplayGame game;
+    unsigned int seed;             // match seed
+    unsigned int mode;             // game specific, e.g. the pong game mode
+    char build[REPLAY_BUILD_SIZE]; // build hash of the recording binary
+} ReplayHeader;
+
+// Per tick input buttons, one byte per tick run-length encoded. Recording streams the
+// runs through stdio, playback maps the file and decodes one run at a time.
+typedef struct Replay {
+    ReplayMode mode;
+    ReplayHeader header;
+    FILE *file;                // recording
+    const unsigned char *data; // playback, the mapped file
+    size_t size, offset;
+    unsigned int buttons;   // buttons of the current run
+    unsigned int runLength; // ticks recorded in the run, or left to play
+    unsigned int ticks;     // ticks recorded or played so far
+} Replay;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+Replay CreateReplayRecorder(const char *path, ReplayGame game, unsigned int seed,
+                            unsigned int mode);
+Replay CreateReplayPlayer(const char *path);
+void DestroyReplay(Replay *replay);
+void ReplayWriteTick(Replay *replay, unsigned int buttons);
+bool ReplayReadTick(Replay *replay, unsigned int *buttons);
+bool ReplayMatchesBuild(const Replay *replay);
+
+#endif // REPLAY_H
@@ -0,0 +1,183 @@
+#include "runtime.h"
+
+#include <math.h>
+#include <raylib.h>
+
+#include "perf_hud.h"
+#include "tick.h"
+#include "trace.h"
+
+#if defined(PLATFORM_WEB)
+#include <emscripten/emscripten.h>
+#endif
+
+// -------------------------------------------------------------------------------------
+// Globals
+// -------------------------------------------------------------------------------------
+// Games, the home one is where the others go back to once they close
+static const Game *homeGame, *currentGame, *nextGame;
+static const Game *loadedGames[RUNTIME_GAMES_MAX];
+static int loadedCount;
+
+// Screens of the current game
+static Screen screen;
+static int nextScreen;
+static bool hasFinished, isFadingIn, isFadingOut;
+static float fading, fadingDir;
+
+// Shared by every game
+static PerfHud perfHud;
+static double enterTime; // when the current game was entered, until its first frame
+static const char *enterEvent;
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static void EnterGame(const Game *game, int screenState) {
+    // assets are loaded once, on the first visit
+    bool loaded = false;
+    for (int i = 0; i < loadedCount; ++i) {
+        loaded = loaded || loadedGames[i] == game;
+    }
+    if (!loaded && loadedCount < RUNTIME_GAMES_MAX) {
+        game->loadAssets();
+        loadedGames[loadedCount++] = game;
+    }
+
+    currentGame = game;
+    nextScreen = 0;
+    nextGame = NULL;
+    hasFinished = false;
+    isFadingIn = true;
+    isFadingOut = false;
+    fading = 0.0f;
+    fadingDir = 1.0f;
+    screen = game->createScreen(screenState);
+    screen.init();
+}
+
+static bool RuntimeShouldClose(void) { return hasFinished && nextGame == NULL; }
+
+static void UpdateRuntime(void) {
+    const Game *game = currentGame;
+
+    float dt = GetFrameTime();
+    TRACE_BEGIN("UpdateScreen");
+    PerfHudBeginFrame(&perfHud);
+
+    // assets loading in the background are picked up as they are ready
+    if (game->pollAssets != NULL) {
+        game->pollAssets();
+    }
+
+    // update screen
+    if (!isFadingIn && !isFadingOut) {
+        TRACE_BEGIN(screen.updateZone);
+        screen.update(dt);
+        TRACE_END();
+    } else {
+        fading += dt * fadingDir;
+    }
+    PerfHudMark(&perfHud, PERF_MARK_UPDATE);
+
+    // render game
+    BeginDrawing();
+    ClearBackground(BLACK);
+    TRACE_BEGIN(screen.renderZone);
+    screen.render(fading / SCREEN_FADE_TIME);
+    TRACE_END();
+    DrawListSubmit(game->drawList);
+    PerfHudMark(&perfHud, PERF_MARK_RENDER);
+    if (*game->debugMode) {
+        RenderPerfHud(&perfHud, 10, 10);
+        RenderDrawListStats(game->drawList, 10, 124);
+    }
+    PerfHudMark(&perfHud, PERF_MARK_OVERLAY);
+    TRACE_BEGIN("EndDrawing");
+    EndDrawing();
+    TRACE_END();
+    if (game->endFrame != NULL) {
+        game->endFrame();
+    }
+    PerfHudEndFrame(&perfHud);
+
+    // from the start of the process, or from the switch with the assets loading
+    if (enterTime > 0.0) {
+        TraceLog(LOG_DEBUG, "%s: first frame %.1f ms after %s", game->name,
+                 1000.0 * (GetSeconds() - enterTime), enterEvent);
+        enterTime = 0.0;
+    }
+
+    if (hasFinished) {
+        isFadingOut = true;
+    }
+
+    if (isFadingIn && fabsf(fading) > SCREEN_FADE_TIME) {
+        isFadingIn = false;
+        fading = SCREEN_FADE_TIME;
+        fadingDir = -1.0f;
+    }
+
+    if (isFadingOut && fabsf(fading) > SCREEN_FADE_TIME) {
+        // start the next screen, in this game or another one
+        if (nextGame != NULL && nextGame != currentGame) {
+            enterTime = GetSeconds();
+            enterEvent = "the switch";
+        }
+        EnterGame(nextGame != NULL ? nextGame : currentGame, nextScreen);
+    }
+    TRACE_END();
+}
+
+void RunGame(const Game *home, int firstScreen, int targetFps) {
+    // initialization, the window, audio and HUD are shared by every game
+    enterTime = GetSeconds();
+    enterEvent = "startup";
+    InitWindow(home->width, home->height, home->name);
+    InitAudioDevice();
+    perfHud = CreatePerfHud();
+    homeGame = home;
+    EnterGame(home, firstScreen);
+
+#if defined(PLATFORM_WEB)
+    emscripten_set_main_loop(UpdateRuntime, 0, 1);
+#else
+    // pos configuration, must happen after window creation
+    if (targetFps > 0) {
+        SetTargetFPS(targetFps);
+    }
+    SetExitKey(KEY_NULL);
+
+    // gameloop
+    while (!WindowShouldClose() && !RuntimeShouldClose()) {
+        UpdateRuntime();
+    }
+#endif
+
+    // cleanup
+    for (int i = loadedCount - 1; i >= 0; --i) {
+        loadedGames[i]->unloadAssets();
+    }
+    loadedCount = 0;
+    DestroyPerfHud(&perfHud);
+    CloseAudioDevice();
+    CloseWindow();
+}
+
+void SwitchGame(const Game *game) {
+    // the current screen fades out first, as for any screen change
+    hasFinished = true;
+    nextGame = game;
+    nextScreen = game->firstScreen;
+}
+
+void SetNextScreen(int screen) {
+    // a closing game goes back home, the home game closing closes the runtime
+    hasFinished = true;
+    nextGame = currentGame;
+    nextScreen = screen;
+    if (screen == 0) {
+        nextGame = currentGame != homeGame ? homeGame : NULL;
+        nextScreen = homeGame->firstScreen;
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef RUNTIME_H
+#define RUNTIME_H
+
+#include <stdbool.h>
+
+#include "draw_list.h"
+
+// Screen constants
+#define SCREEN_FADE_TIME 0.3f
+
+// Games whose assets stay loaded at once
+#define RUNTIME_GAMES_MAX 8
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+typedef struct Screen {
+    void (*init)(void);
+    void (*update)(float dt);
+    void (*render)(float fading);        // 0 to 1 while fading in, 1 to 0 out
+    const char *updateZone, *renderZone; // trace zone names
+} Screen;
+
+// A game as the runtime runs it, its screens are created from the game's own screen
+// enum where 0 is no screen. Its assets are loaded the first time the game is
+// entered and kept until the runtime closes, so switching back loads nothing.
+typedef struct Game {
+    const char *name; // the window title when it opens the window
+    int width, height;
+    Screen (*createScreen)(int screen);
+    int firstScreen; // entered from another game
+    void (*loadAssets)(void);
+    void (*unloadAssets)(void);
+    void (*pollAssets)(void); // every frame before the update, may be NULL
+    void (*endFrame)(void);   // once the frame is presented, may be NULL
+    DrawList *drawList;       // the screens append to it, submitted after they render
+    const bool *debugMode;    // shows the perf HUD and the draw list stats
+} Game;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+void RunGame(const Game *home, int firstScreen, int targetFps);
+void SwitchGame(const Game *game);
+void SetNextScreen(int screen);
+
+#endif // RUNTIME_H
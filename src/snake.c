@@ -1,28 +1,42 @@
 #include <math.h>
 #include <raylib.h>
 #include <raymath.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
-#if defined(PLATFORM_WEB)
-#include <emscripten/emscripten.h>
-#endif
-
-#ifndef ASSET_PATH
-#define ASSET_PATH "./assets"
-#endif
+#include "draw_list.h"
+#include "golden.h"
+#include "replay.h"
+#include "runtime.h"
+#include "snake_autopilot.h"
+#include "snake_sim.h"
+#include "tick.h"
+#include "trace.h"
+#include "video.h"
 
 // Screen constants
-#define SCREEN_TITLE     "Snake"
-#define SCREEN_WIDTH     800
-#define SCREEN_HEIGHT    600
-#define SCREEN_FADE_TIME 0.3f
+#define SCREEN_TITLE "Snake"
 
-#define GRID_WIDTH  20
-#define GRID_HEIGHT 20
 #define GRID_MARGIN 3
+#define GRID_COLOR  (Color){20, 20, 20, 255}
+
+// Snake steps simulated at most per frame, longer hitches are dropped
+#define TICK_CATCHUP_MAX 4
 
-#define SNAKE_BUFFER_SIZE 20
+// Snake steps run every frame by fast replay playback
+#define REPLAY_FAST_TICKS 1000
+
+// Golden images, every screen rendered on the CPU after the same scripted chase
+#define GOLDEN_SEED       1
+#define GOLDEN_STEPS      120
+#define GOLDEN_FADES      5
+#define GOLDEN_BENCH_TIME 0.25
+
+// Video export, frames per second of the stream and the longest game it holds
+#define EXPORT_FPS         60
+#define EXPORT_SECONDS_MAX 300
 
 // -------------------------------------------------------------------------------------
 // Enumerations
@@ -34,72 +48,139 @@ typedef enum {
     SCREEN_COUNT
 } ScreenState;
 
-typedef enum {
-    DIR_NONE = 0,
-    DIR_UP,
-    DIR_RIGHT,
-    DIR_DOWN,
-    DIR_LEFT,
-    DIR_COUNT
-} Direction;
-
 // -------------------------------------------------------------------------------------
 // Structs
 // -------------------------------------------------------------------------------------
-typedef struct Screen {
-    void (*init)(void);
-    void (*update)(float dt);
-    void (*render)(float fading);
-    bool hasFinished;
-} Screen;
+typedef struct GoldenScreen {
+    const char *name;
+    ScreenState screen;
+} GoldenScreen;
 
 // -------------------------------------------------------------------------------------
 // Globals
 // -------------------------------------------------------------------------------------
 // Screens
-static Screen screens[SCREEN_COUNT];
-static ScreenState currentScreen, nextScreen;
-
-static const Vector2 dirVectors[] = {
-    {0.0f, 0.0f}, {0.0f, -1.0f}, {1.0f, 0.0f}, {0.0f, 1.0f}, {-1.0f, 0.0f}};
-
-static Vector2 snake[SNAKE_BUFFER_SIZE];
-static int snakeHead, snakeTail;
-static float snakeTimer, snakeSpeed;
-static Direction snakeDir;
-
-static Vector2 apple;
+static DrawList drawList; // render callbacks append to it, submitted once sorted
+
+// Game
+static bool debugMode;
+static SnakeState game;
+static RenderTexture2D gridLayer; // background grid, baked once and drawn as one quad
+static Raster gridRaster;         // the same grid for CPU frames, copied under them
+static TickClock snakeClock;
+static float snakeAlpha;
+
+// Replay, one tick per snake step storing the requested direction
+static Replay replay;
+static const char *recordPath; // every game overwrites it, the last one is kept
+static bool replayFast;
+#if !defined(ARCADE)
+static bool replayRender = true;
+#endif
+static double replayStart;
 
 // -------------------------------------------------------------------------------------
 // Module declaration
 // -------------------------------------------------------------------------------------
-// Screen management
-void InitScreen(ScreenState initialScreen);
-void SetNextScreen(ScreenState state);
-bool ScreenShouldClose(void);
-void UpdateScreen(void);
+// Screen management, the window and the fades are the runtime's
+static Screen CreateScreen(int screenState);
 
 // Menu screen
-void InitMenuScreen(void);
-void UpdateMenuScreen(float dt);
-void RenderMenuScreen(float fading);
+static void InitMenuScreen(void);
+static void UpdateMenuScreen(float dt);
+static void RenderMenuScreen(float fading);
 
 // Game screen
-void InitGameScreen(void);
-void UpdateGameScreen(float dt);
-void RenderGameScreen(float fading);
+static void InitGameScreen(void);
+static void UpdateGameScreen(float dt);
+static void RenderGameScreen(float fading);
+
+// Game, shared by the game screen and windowless playback
+static void EndGame(ScreenState screen);
+static void ReportReplay(double elapsed);
+
+#if !defined(ARCADE)
+// Replay playback, windowless
+static int RunReplay(void);
+
+// Golden images, windowless
+static int RunGolden(const char *path, bool update);
+static bool SetupGolden(void);
+static void RenderGolden(const GoldenScreen *golden, Raster *raster, float fading);
+
+// Video export, windowless
+static int RunExport(const char *path, VideoFormat format);
+#endif
 
 // Helper functions
-void InitAssets(void);
-void DestroyAssets(void);
-Vector2 GeneratePoint(void);
-void DrawBlock(float fading, float x, float y, Color color);
-void RenderGrid(float fading);
+static void InitAssets(void);
+static void DestroyAssets(void);
+static Vector2 CellPosition(int cell);
+static Vector2 LerpCell(int from, int to, float amount);
+static void DrawBlock(DrawList *list, float fading, float x, float y, Color color);
+static void BakeGridLayer(void);
+#if !defined(ARCADE)
+static void BakeGridRaster(void);
+#endif
+static void RenderGrid(float fading);
+
+// -------------------------------------------------------------------------------------
+// Game module, also linked into the launcher
+// -------------------------------------------------------------------------------------
+const Game snakeGame = {.name = SCREEN_TITLE,
+                        .width = SCREEN_WIDTH,
+                        .height = SCREEN_HEIGHT,
+                        .createScreen = &CreateScreen,
+                        .firstScreen = SCREEN_MENU,
+                        .loadAssets = &InitAssets,
+                        .unloadAssets = &DestroyAssets,
+                        .pollAssets = NULL,
+                        .endFrame = NULL,
+                        .drawList = &drawList,
+                        .debugMode = &debugMode};
 
 // -------------------------------------------------------------------------------------
 // Entrypoint
 // -------------------------------------------------------------------------------------
-int main(void) {
+#if !defined(ARCADE)
+int main(int argc, char **argv) {
+    const char *playPath = NULL, *tracePath = NULL, *goldenPath = NULL;
+    const char *exportPath = NULL;
+    bool validArgs = true, goldenUpdate = false, exportPpm = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--play") == 0 && i + 1 < argc) {
+            playPath = argv[++i];
+        } else if (strcmp(argv[i], "--fast") == 0) {
+            replayFast = true;
+        } else if (strcmp(argv[i], "--no-render") == 0) {
+            replayRender = false;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc) {
+            goldenPath = argv[++i];
+        } else if (strcmp(argv[i], "--update") == 0) {
+            goldenUpdate = true;
+        } else if (strcmp(argv[i], "--export") == 0 && i + 1 < argc) {
+            exportPath = argv[++i];
+        } else if (strcmp(argv[i], "--ppm") == 0) {
+            exportPpm = true;
+        } else {
+            validArgs = false;
+        }
+    }
+    if (!validArgs || ((replayFast || !replayRender) && playPath == NULL) ||
+        (goldenUpdate && goldenPath == NULL) || (exportPpm && exportPath == NULL) ||
+        (exportPath != NULL && (replayFast || !replayRender))) {
+        fprintf(stderr,
+                "usage: %s [--record FILE] [--play FILE [--fast] [--no-render]]\n"
+                "          [--trace FILE] [--golden FILE [--update]]\n"
+                "          [--export FILE|- [--ppm]]\n",
+                argv[0]);
+        return 1;
+    }
 
 // pre configuration
 #if defined(DEBUG)
@@ -108,256 +189,513 @@ int main(void) {
     SetTraceLogLevel(LOG_NONE);
 #endif
 
-    // initialization
-    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_TITLE);
-    InitScreen(SCREEN_MENU);
-    InitAudioDevice();
-    InitAssets();
+    // golden images are checked without a window or a GL context
+    if (goldenPath != NULL) {
+        return RunGolden(goldenPath, goldenUpdate);
+    }
 
-#if defined(PLATFORM_WEB)
-    emscripten_set_main_loop(UpdateScreen, 0, 1);
-#else
-    // pos configuration, must happen after window creation
-    SetTargetFPS(60);
-    SetExitKey(KEY_NULL);
+    // a replay starts straight into its game, without a window if not rendered
+    if (playPath != NULL) {
+        replay = CreateReplayPlayer(playPath);
+        if (replay.mode != REPLAY_PLAY || replay.header.game != REPLAY_GAME_SNAKE) {
+            fprintf(stderr, "%s: not a snake replay\n", playPath);
+            return 1;
+        }
+        if (!ReplayMatchesBuild(&replay)) {
+            TraceLog(LOG_WARNING, "Replay recorded by build %s, it may not match",
+                     replay.header.build);
+        }
+        if (!replayRender) {
+            return RunReplay();
+        }
+    }
 
-    // gameloop
-    while (!WindowShouldClose() && !ScreenShouldClose()) {
-        UpdateScreen();
+    // the replay, or a game of the autopilot, rendered to a video stream
+    if (exportPath != NULL) {
+        return RunExport(exportPath, exportPpm ? VIDEO_PPM : VIDEO_Y4M);
     }
-#endif
 
-    // cleanup
-    DestroyAssets();
-    CloseAudioDevice();
-    CloseWindow();
+    // profiling zones, written when the game exits
+    if (tracePath != NULL && !InitTrace(tracePath)) {
+        fprintf(stderr, "built without TRACE=1, no zones to write to %s\n", tracePath);
+    }
+    TRACE_THREAD("main");
+
+    // window, assets and screens, until the last screen closes
+    RunGame(&snakeGame, playPath != NULL ? SCREEN_GAME : SCREEN_MENU,
+            replayFast ? 0 : 60);
+    if (tracePath != NULL && CloseTrace()) {
+        printf("trace written to %s\n", tracePath);
+    }
 
     return 0;
 }
+#endif
 
 // -------------------------------------------------------------------------------------
 // Module implementation
 // -------------------------------------------------------------------------------------
-Screen CreateScreen(ScreenState screenState) {
+static Screen CreateScreen(int screenState) {
     Screen screen;
-    screen.hasFinished = false;
 
     switch (screenState) {
     case SCREEN_MENU:
         screen.init = &InitMenuScreen;
         screen.update = &UpdateMenuScreen;
         screen.render = &RenderMenuScreen;
+        screen.updateZone = "UpdateMenuScreen";
+        screen.renderZone = "RenderMenuScreen";
         break;
     case SCREEN_GAME:
         screen.init = &InitGameScreen;
         screen.update = &UpdateGameScreen;
         screen.render = &RenderGameScreen;
+        screen.updateZone = "UpdateGameScreen";
+        screen.renderZone = "RenderGameScreen";
         break;
     default:
         screen.init = NULL;
         screen.update = NULL;
         screen.render = NULL;
+        screen.updateZone = NULL;
+        screen.renderZone = NULL;
     }
 
     return screen;
 }
 
-void InitScreen(ScreenState initialScreen) {
-    // create screens
-    for (int i = 0; i < SCREEN_COUNT; ++i) {
-        screens[i] = CreateScreen(i);
-    }
-
-    // set initial screen
-    currentScreen = initialScreen;
-    nextScreen = SCREEN_NONE;
-    screens[currentScreen].init();
-}
+static void InitMenuScreen(void) { TraceLog(LOG_DEBUG, "Menu Screen"); }
 
-void SetNextScreen(ScreenState screen) {
-    screens[currentScreen].hasFinished = true;
-    nextScreen = screen;
+static void UpdateMenuScreen(float dt) {
+    if (IsKeyPressed(KEY_ESCAPE)) {
+        SetNextScreen(SCREEN_NONE);
+    }
+    if (IsKeyPressed(KEY_ENTER)) {
+        SetNextScreen(SCREEN_GAME);
+    }
 }
 
-bool ScreenShouldClose(void) {
-    return screens[currentScreen].hasFinished && nextScreen == SCREEN_NONE;
+static void RenderMenuScreen(float fading) {
+    int titleMeasure = DrawListMeasureText(&drawList, "SNAKE", 64);
+    DrawListText(&drawList, "SNAKE", (SCREEN_WIDTH - titleMeasure) / 2.0f, 140, 64,
+                 Fade(WHITE, fading));
 }
 
-void UpdateScreen(void) {
-    static bool isFadingIn = true;
-    static bool isFadingOut = false;
-    static float fadingDir = 1.0f, fading = 0.0f;
+static void InitGameScreen(void) {
+    TraceLog(LOG_DEBUG, "Game Screen");
 
-    float dt = GetFrameTime();
+    // playback brings its own seed, recording starts a new file for every game
+    unsigned int seed = (unsigned int)time(NULL);
+    if (replay.mode == REPLAY_PLAY) {
+        seed = replay.header.seed;
+        replayStart = GetTime();
+    } else if (recordPath != NULL) {
+        DestroyReplay(&replay);
+        replay = CreateReplayRecorder(recordPath, REPLAY_GAME_SNAKE, seed, 0);
+        if (replay.mode != REPLAY_RECORD) {
+            TraceLog(LOG_WARNING, "Can't record the game to %s", recordPath);
+        }
+    }
 
-    // update screen
-    if (!isFadingIn && !isFadingOut) {
-        screens[currentScreen].update(dt);
+    if (game.body == NULL) {
+        game = CreateSnakeState(seed);
     } else {
-        fading += dt * fadingDir;
+        SnakeInit(&game, seed);
     }
+    if (game.body == NULL) {
+        TraceLog(LOG_ERROR, "Can't allocate the snake");
+        EndGame(SCREEN_MENU);
+    }
+    snakeClock = CreateTickClock(replayFast ? REPLAY_FAST_TICKS : TICK_CATCHUP_MAX);
+    snakeAlpha = 0.0f;
+}
 
-    // render game
-    BeginDrawing();
-    ClearBackground(BLACK);
-    screens[currentScreen].render(fading / SCREEN_FADE_TIME);
-    EndDrawing();
-
-    if (screens[currentScreen].hasFinished) {
-        isFadingOut = true;
+static void UpdateGameScreen(float dt) {
+    // without a snake the game has already ended, it only fades out
+    if (game.body == NULL) {
+        return;
+    }
+    if (IsKeyPressed(KEY_ESCAPE)) {
+        EndGame(SCREEN_MENU);
+        return;
+    }
+    if (IsKeyPressed(KEY_D)) {
+        debugMode = !debugMode;
     }
 
-    if (isFadingIn && fabsf(fading) > SCREEN_FADE_TIME) {
-        isFadingIn = false;
-        fading = SCREEN_FADE_TIME;
-        fadingDir = -1.0f;
+    if (IsKeyPressed(KEY_UP)) {
+        game.dir = DIR_UP;
+    }
+    if (IsKeyPressed(KEY_RIGHT)) {
+        game.dir = DIR_RIGHT;
+    }
+    if (IsKeyPressed(KEY_DOWN)) {
+        game.dir = DIR_DOWN;
+    }
+    if (IsKeyPressed(KEY_LEFT)) {
+        game.dir = DIR_LEFT;
     }
 
-    if (isFadingOut && fabsf(fading) > SCREEN_FADE_TIME) {
-        // reset previous
-        screens[currentScreen].hasFinished = false;
-        isFadingOut = false;
-        isFadingIn = true;
-        fading = 0.0f;
-        fadingDir = 1.0f;
+    // one tick per snake step, the step length shrinks as the snake speeds up. Fast
+    // playback banks a large batch of steps every frame instead.
+    TickClockAdvance(&snakeClock, replayFast ? REPLAY_FAST_TICKS / game.speed : dt);
+    while (TickClockConsume(&snakeClock, 1.0f / game.speed)) {
+        // playback takes the recorded direction, the live one is recorded if asked
+        if (replay.mode == REPLAY_PLAY) {
+            unsigned int dir;
+            if (!ReplayReadTick(&replay, &dir)) {
+                EndGame(SCREEN_NONE);
+                break;
+            }
+            game.dir = dir;
+        }
+        ReplayWriteTick(&replay, game.dir);
+
+        SnakeStep(&game);
 
-        // start new
-        currentScreen = nextScreen;
-        nextScreen = SCREEN_NONE;
-        screens[currentScreen].init();
+        if (game.events & (SNAKE_EVENT_DEAD | SNAKE_EVENT_WIN)) {
+            TraceLog(LOG_DEBUG, "Game over, length %d", game.length);
+            EndGame(SCREEN_MENU);
+            break;
+        }
     }
+    snakeAlpha = TickClockAlpha(&snakeClock, 1.0f / game.speed);
 }
 
-void InitMenuScreen(void) { TraceLog(LOG_DEBUG, "Menu Screen"); }
+static void RenderGameScreen(float fading) {
+    // background grid, only baked again when the window changes size
+    if (IsWindowResized()) {
+        BakeGridLayer();
+    }
+    RenderGrid(fading);
+    DrawListLayer(&drawList, 1);
 
-void UpdateMenuScreen(float dt) {
-    if (IsKeyPressed(KEY_ESCAPE)) {
-        SetNextScreen(SCREEN_NONE);
+    if (game.body == NULL) {
+        return;
     }
-    if (IsKeyPressed(KEY_ENTER)) {
-        SetNextScreen(SCREEN_GAME);
+
+    // render apple
+    if (game.apple >= 0) {
+        Vector2 apple = CellPosition(game.apple);
+        DrawBlock(&drawList, fading, apple.x, apple.y, GREEN);
     }
+
+    // draw snake, the head is drawn on its own below
+    for (int i = 0; i < game.length - 1; ++i) {
+        Vector2 snakePart = CellPosition(SnakeBodyCell(&game, i));
+        DrawBlock(&drawList, fading, snakePart.x, snakePart.y, WHITE);
+    }
+
+    // head and tail slide between the last two steps
+    Vector2 tailPos = LerpCell(game.prevTail, SnakeBodyCell(&game, 0), snakeAlpha);
+    Vector2 headPos = LerpCell(game.prevHead, SnakeHead(&game), snakeAlpha);
+    DrawBlock(&drawList, fading, tailPos.x, tailPos.y, WHITE);
+    DrawBlock(&drawList, fading, headPos.x, headPos.y, WHITE);
 }
 
-void RenderMenuScreen(float fading) {
-    int titleMeasure = MeasureText("SNAKE", 64);
-    DrawText("SNAKE", (SCREEN_WIDTH - titleMeasure) / 2.0f, 140, 64,
-             Fade(WHITE, fading));
+static void EndGame(ScreenState screen) {
+    // playback only shows its own game, recording closes the file of this one
+    if (replay.mode == REPLAY_PLAY) {
+        ReportReplay(GetTime() - replayStart);
+        screen = SCREEN_NONE;
+    }
+    DestroyReplay(&replay);
+    SetNextScreen(screen);
 }
 
-void InitGameScreen(void) {
-    TraceLog(LOG_DEBUG, "Game Screen");
-    SetRandomSeed(time(NULL));
-
-    snakeHead = 2;
-    snakeTail = 0;
-    snake[0] = (Vector2){0, 0};
-    snake[1] = (Vector2){GRID_WIDTH, 0};
-    snake[2] = (Vector2){2 * GRID_WIDTH, 0};
-    snakeTimer = 0;
-    snakeSpeed = 5; // blocks per second
-    snakeDir = DIR_RIGHT;
-
-    apple = GeneratePoint();
+static void ReportReplay(double elapsed) {
+    printf("replay: %u steps in %.3f s, length %d\n", replay.ticks, elapsed,
+           game.length);
 }
 
-void UpdateGameScreen(float dt) {
-    if (IsKeyPressed(KEY_ESCAPE)) {
-        SetNextScreen(SCREEN_MENU);
+#if !defined(ARCADE)
+static int RunReplay(void) {
+    // no window, the game runs as fast as the replay decodes
+    game = CreateSnakeState(replay.header.seed);
+    if (game.body == NULL) {
+        fprintf(stderr, "can't allocate the snake\n");
+        DestroyReplay(&replay);
+        return 1;
     }
 
-    if (IsKeyPressed(KEY_UP)) {
-        snakeDir = DIR_UP;
+    clock_t start = clock();
+    unsigned int dir;
+    while (ReplayReadTick(&replay, &dir)) {
+        game.dir = dir;
+        SnakeStep(&game);
+        if (game.events & (SNAKE_EVENT_DEAD | SNAKE_EVENT_WIN)) {
+            break;
+        }
     }
-    if (IsKeyPressed(KEY_RIGHT)) {
-        snakeDir = DIR_RIGHT;
+    ReportReplay((double)(clock() - start) / CLOCKS_PER_SEC);
+
+    DestroyReplay(&replay);
+    DestroySnakeState(&game);
+
+    return 0;
+}
+
+static int RunGolden(const char *path, bool update) {
+    // no window, every screen is rendered into a CPU raster at a few fade levels
+    static const GoldenScreen goldens[] = {{"menu", SCREEN_MENU},
+                                           {"game", SCREEN_GAME}};
+    int goldenCount = sizeof(goldens) / sizeof(GoldenScreen);
+
+    Raster raster = CreateRaster(SCREEN_WIDTH, SCREEN_HEIGHT);
+    drawList = CreateDrawList(&raster);
+    GoldenSet set = LoadGoldenSet(path);
+    if (!SetupGolden()) {
+        fprintf(stderr, "can't allocate the snake\n");
+        DestroyDrawList(&drawList);
+        DestroyRaster(&raster);
+        return 1;
     }
-    if (IsKeyPressed(KEY_DOWN)) {
-        snakeDir = DIR_DOWN;
+
+    for (int i = 0; i < goldenCount; ++i) {
+        for (int fade = 0; fade < GOLDEN_FADES; ++fade) {
+            RenderGolden(&goldens[i], &raster, (float)fade / (GOLDEN_FADES - 1));
+
+            char name[GOLDEN_NAME_SIZE];
+            snprintf(name, sizeof(name), "%s_%d", goldens[i].name,
+                     100 * fade / (GOLDEN_FADES - 1));
+            GoldenResult result = CheckGolden(&set, name, &raster, update);
+            if (result != GOLDEN_MATCH) {
+                printf("%s: %s\n", name, result == GOLDEN_MISMATCH ? "differs" : "new");
+            }
+        }
+
+        // render speed of the fully faded in screen
+        clock_t start = clock();
+        int frames = 0;
+        double elapsed = 0.0;
+        while (elapsed < GOLDEN_BENCH_TIME) {
+            RenderGolden(&goldens[i], &raster, 1.0f);
+            ++frames;
+            elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+        }
+        printf("%-12s %8.0f frames/s\n", goldens[i].name, frames / elapsed);
     }
-    if (IsKeyPressed(KEY_LEFT)) {
-        snakeDir = DIR_LEFT;
-    }
-
-    snakeTimer += dt;
-    if (snakeTimer > 1.0f / snakeSpeed) {
-        snakeTimer -= 1.0f / snakeSpeed;
-
-        // New head
-        int previousHead = snakeHead;
-        snakeHead = (snakeHead + 1) % SNAKE_BUFFER_SIZE;
-        snake[snakeHead].x =
-            snake[previousHead].x + dirVectors[snakeDir].x * GRID_WIDTH;
-        snake[snakeHead].y =
-            snake[previousHead].y + dirVectors[snakeDir].y * GRID_HEIGHT;
-
-        // eat apple
-        if ((int)snake[snakeHead].x == (int)apple.x &&
-            (int)snake[snakeHead].y == (int)apple.y) {
-            apple = GeneratePoint();
-            snakeSpeed *= 1.1f;
+
+    printf("golden: %d match, %d differ, %d new\n", set.matched, set.mismatched,
+           set.missing);
+    if (update && !SaveGoldenSet(&set)) {
+        fprintf(stderr, "%s: can't write the golden hashes\n", path);
+    } else if (!update && set.missing > 0) {
+        fprintf(stderr, "%s: frames without a hash, record them with --update\n", path);
+    }
+
+    DestroyDrawList(&drawList);
+    DestroyRaster(&raster);
+    DestroySnakeState(&game);
+
+    return !update && (set.mismatched > 0 || set.missing > 0) ? 1 : 0;
+}
+
+static bool SetupGolden(void) {
+    // the snake chases the apple, across first then along the column
+    game = CreateSnakeState(GOLDEN_SEED);
+    if (game.body == NULL) {
+        return false;
+    }
+    for (int step = 0; step < GOLDEN_STEPS && game.apple >= 0; ++step) {
+        int head = SnakeHead(&game);
+        if (head % GRID_COLUMNS != game.apple % GRID_COLUMNS) {
+            game.dir = head % GRID_COLUMNS < game.apple % GRID_COLUMNS ? DIR_RIGHT
+                                                                       : DIR_LEFT;
         } else {
-            // pop tail
-            snakeTail = (snakeTail + 1) % SNAKE_BUFFER_SIZE;
+            game.dir = head < game.apple ? DIR_DOWN : DIR_UP;
+        }
+        SnakeStep(&game);
+        if (game.events & (SNAKE_EVENT_DEAD | SNAKE_EVENT_WIN)) {
+            break;
         }
     }
+    snakeAlpha = 0.5f;
+    return true;
 }
 
-void RenderGameScreen(float fading) {
-    ClearBackground(BLACK);
+static void RenderGolden(const GoldenScreen *golden, Raster *raster, float fading) {
+    RasterClear(raster, BLACK);
+    CreateScreen(golden->screen).render(fading);
+    DrawListSubmit(&drawList);
+}
 
-    // debug drawing
-    RenderGrid(fading);
+static int RunExport(const char *path, VideoFormat format) {
+    // raylib logs to stdout, which may be the stream itself
+    SetTraceLogLevel(LOG_NONE);
 
-    // render apple
-    DrawBlock(fading, apple.x, apple.y, GREEN);
+    VideoWriter writer =
+        CreateVideoWriter(path, format, SCREEN_WIDTH, SCREEN_HEIGHT, EXPORT_FPS);
+    if (!StartVideoWriter(&writer)) {
+        fprintf(stderr, "%s: can't write the video\n", path);
+        DestroyVideoWriter(&writer);
+        DestroyReplay(&replay);
+        return 1;
+    }
+
+    // without a replay the autopilot plays
+    bool playing = replay.mode == REPLAY_PLAY;
+    SnakeAutopilot *pilot = NULL;
+    if (playing) {
+        game = CreateSnakeState(replay.header.seed);
+    } else {
+        game = CreateSnakeState((unsigned int)time(NULL));
+        pilot = malloc(sizeof(SnakeAutopilot));
+        if (pilot != NULL) {
+            *pilot = CreateSnakeAutopilot();
+        }
+    }
+    if (game.body == NULL || (!playing && pilot == NULL)) {
+        fprintf(stderr, "can't allocate the snake\n");
+        free(pilot);
+        DestroySnakeState(&game);
+        DestroyVideoWriter(&writer);
+        DestroyReplay(&replay);
+        return 1;
+    }
+    snakeClock = CreateTickClock(TICK_CATCHUP_MAX);
+    BakeGridRaster();
+
+    // no window, the game runs at the video rate and every frame is drawn on the
+    // CPU into the next free raster of the writer, as fast as the encoder takes them
+    drawList = CreateDrawList(&writer.frames[0]);
+    bool over = false;
+    for (int frames = 0; !over && frames < EXPORT_FPS * EXPORT_SECONDS_MAX; ++frames) {
+        TickClockAdvance(&snakeClock, 1.0f / EXPORT_FPS);
+        while (TickClockConsume(&snakeClock, 1.0f / game.speed)) {
+            if (playing) {
+                unsigned int dir;
+                if (!ReplayReadTick(&replay, &dir)) {
+                    over = true;
+                    break;
+                }
+                game.dir = dir;
+            } else {
+                game.dir = SnakeAutopilotStep(pilot, &game);
+            }
+            SnakeStep(&game);
+            if (game.events & (SNAKE_EVENT_DEAD | SNAKE_EVENT_WIN)) {
+                over = true;
+                break;
+            }
+        }
+        snakeAlpha = TickClockAlpha(&snakeClock, 1.0f / game.speed);
+
+        Raster *frame = VideoWriterAcquire(&writer);
+        if (frame == NULL) {
+            break;
+        }
+        drawList.raster = frame;
+        RasterCopy(frame, &gridRaster);
+        RenderGameScreen(1.0f);
+        DrawListSubmit(&drawList);
+        VideoWriterSubmit(&writer);
+    }
 
-    // draw apple
-    int tail = snakeTail;
-    while (tail != snakeHead) {
-        Vector2 snakePart = snake[tail];
-        DrawBlock(fading, snakePart.x, snakePart.y, WHITE);
-        tail = (tail + 1) % SNAKE_BUFFER_SIZE;
+    bool written = DestroyVideoWriter(&writer);
+    VideoWriterReport(&writer);
+    if (!written) {
+        fprintf(stderr, "%s: the video could not be written\n", path);
     }
 
-    // draw head
-    DrawBlock(fading, snake[snakeHead].x, snake[snakeHead].y, WHITE);
+    free(pilot);
+    DestroyRaster(&gridRaster);
+    DestroyDrawList(&drawList);
+    DestroyReplay(&replay);
+    DestroySnakeState(&game);
+
+    return written ? 0 : 1;
 }
+#endif
 
-void InitAssets(void) { ChangeDirectory(ASSET_PATH); }
+static void InitAssets(void) {
+    TRACE_BEGIN("InitAssets");
+    drawList = CreateDrawList(NULL);
+    BakeGridLayer();
+    TRACE_END();
+}
 
-void DestroyAssets(void) {}
+static void DestroyAssets(void) {
+    DestroyReplay(&replay);
+    DestroySnakeState(&game);
+    DestroyDrawList(&drawList);
+    UnloadRenderTexture(gridLayer);
+}
 
-void DrawBlock(float fading, float x, float y, Color color) {
-    int gridX = ((int)x / GRID_WIDTH) * GRID_WIDTH;
-    int gridY = ((int)y / GRID_HEIGHT) * GRID_HEIGHT;
-    Rectangle rect = {gridX, gridY, GRID_WIDTH, GRID_HEIGHT};
-    Rectangle innerRect = {gridX + GRID_MARGIN, gridY + GRID_MARGIN,
-                           GRID_WIDTH - 2 * GRID_MARGIN, GRID_HEIGHT - 2 * GRID_MARGIN};
-    DrawRectangleLinesEx(rect, 1.0, Fade(color, fading));
-    DrawRectangleRec(innerRect, Fade(color, fading));
+static Vector2 CellPosition(int cell) {
+    return (Vector2){(cell % GRID_COLUMNS) * GRID_WIDTH,
+                     (cell / GRID_COLUMNS) * GRID_HEIGHT};
 }
 
-Vector2 GeneratePoint(void) {
-    Vector2 point;
+static Vector2 LerpCell(int from, int to, float amount) {
+    Vector2 fromPos = CellPosition(from), toPos = CellPosition(to);
 
-    point.x = GetRandomValue(0, SCREEN_WIDTH / GRID_WIDTH - 1) * GRID_WIDTH;
-    point.y = GetRandomValue(0, SCREEN_HEIGHT / GRID_HEIGHT - 1) * GRID_HEIGHT;
+    // don't slide across the whole board when wrapping around an edge
+    if (fabsf(toPos.x - fromPos.x) > GRID_WIDTH ||
+        fabsf(toPos.y - fromPos.y) > GRID_HEIGHT) {
+        return toPos;
+    }
+    return Vector2Lerp(fromPos, toPos, amount);
+}
 
-    return point;
+static void DrawBlock(DrawList *list, float fading, float x, float y, Color color) {
+    // callers pass grid aligned positions, except for interpolated blocks
+    Rectangle rect = {x, y, GRID_WIDTH, GRID_HEIGHT};
+    Rectangle innerRect = {x + GRID_MARGIN, y + GRID_MARGIN,
+                           GRID_WIDTH - 2 * GRID_MARGIN, GRID_HEIGHT - 2 * GRID_MARGIN};
+    DrawListRectangleLines(list, rect, 1.0f, Fade(color, fading));
+    DrawListRectangle(list, innerRect, Fade(color, fading));
 }
 
-void RenderGrid(float fading) {
-    Color gridColor = {20, 20, 20, 255};
-    int linesWidth, linesHeight;
+static void BakeGridLayer(void) {
+    UnloadRenderTexture(gridLayer);
+    gridLayer = LoadRenderTexture(SCREEN_WIDTH, SCREEN_HEIGHT);
+
+    // drawn opaque on a transparent layer, the fade is applied when compositing. Its
+    // own list, the frame one may be half filled when the window is resized.
+    DrawList bakeList = CreateDrawList(NULL);
+    BeginTextureMode(gridLayer);
+    ClearBackground(BLANK);
+    for (int cell = 0; cell < GRID_CELLS; ++cell) {
+        Vector2 position = CellPosition(cell);
+        DrawBlock(&bakeList, 1.0f, position.x, position.y, GRID_COLOR);
+    }
+    DrawListSubmit(&bakeList);
+    EndTextureMode();
+    DestroyDrawList(&bakeList);
+}
 
-    gridColor = Fade(gridColor, fading);
-    linesWidth = SCREEN_WIDTH / GRID_WIDTH;
-    linesHeight = SCREEN_HEIGHT / GRID_HEIGHT;
+#if !defined(ARCADE)
+static void BakeGridRaster(void) {
+    // opaque over black, CPU frames are only exported fully faded in
+    gridRaster = CreateRaster(SCREEN_WIDTH, SCREEN_HEIGHT);
+    DrawList bakeList = CreateDrawList(&gridRaster);
+    RasterClear(&gridRaster, BLACK);
+    for (int cell = 0; cell < GRID_CELLS; ++cell) {
+        Vector2 position = CellPosition(cell);
+        DrawBlock(&bakeList, 1.0f, position.x, position.y, GRID_COLOR);
+    }
+    DrawListSubmit(&bakeList);
+    DestroyDrawList(&bakeList);
+}
+#endif
 
-    for (int y = 0; y < linesHeight; ++y) {
-        for (int x = 0; x < linesWidth; ++x) {
-            DrawBlock(fading, x * GRID_WIDTH, y * GRID_HEIGHT, gridColor);
+static void RenderGrid(float fading) {
+    // without a GL context there is no baked layer: a CPU frame either starts as a
+    // copy of the baked raster, or the blocks are drawn one by one
+    TRACE_BEGIN("RenderGrid");
+    if (gridLayer.id == 0) {
+        for (int cell = 0; gridRaster.pixels == NULL && cell < GRID_CELLS; ++cell) {
+            Vector2 position = CellPosition(cell);
+            DrawBlock(&drawList, fading, position.x, position.y, GRID_COLOR);
         }
+        TRACE_END();
+        return;
     }
+
+    // render textures are stored upside down
+    Rectangle source = {0, 0, gridLayer.texture.width, -gridLayer.texture.height};
+    DrawListTexture(&drawList, gridLayer.texture, source, (Vector2){0, 0},
+                    Fade(WHITE, fading));
+    TRACE_END();
 }
@@ -0,0 +1,136 @@
+#include "snake_autopilot.h"
+
+#include <limits.h>
+#include <string.h>
+
+// The cycle below walks row 0, then zigzags back through the other rows
+#if GRID_ROWS % 2 != 0
+#error "the Hamiltonian cycle needs an even number of grid rows"
+#endif
+
+static const int dirX[] = {0, 0, 1, 0, -1};
+static const int dirY[] = {0, -1, 0, 1, 0};
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static int NeighborCell(int cell, Direction dir) {
+    int x = (cell % GRID_COLUMNS + dirX[dir] + GRID_COLUMNS) % GRID_COLUMNS;
+    int y = (cell / GRID_COLUMNS + dirY[dir] + GRID_ROWS) % GRID_ROWS;
+    return y * GRID_COLUMNS + x;
+}
+
+static int CycleDistance(const SnakeAutopilot *pilot, int from, int to) {
+    return (pilot->cycleIndex[to] - pilot->cycleIndex[from] + GRID_CELLS) % GRID_CELLS;
+}
+
+static bool WasReached(const SnakeAutopilot *pilot, int cell) {
+    return pilot->visited[cell] == pilot->field;
+}
+
+// Breadth first search from the apple over the cells outside the body
+static void FillDistance(SnakeAutopilot *pilot, const SnakeState *state) {
+    int *distance = pilot->distance;
+    int *queue = pilot->queue;
+    int first = 0, last = 0;
+
+    // a new stamp clears the previous field without touching every cell
+    if (++pilot->field == 0) {
+        memset(pilot->visited, 0, sizeof(pilot->visited));
+        pilot->field = 1;
+    }
+    pilot->visited[state->apple] = pilot->field;
+    distance[state->apple] = 0;
+    queue[last++] = state->apple;
+
+    while (first < last) {
+        int cell = queue[first++];
+        for (Direction dir = DIR_UP; dir < DIR_COUNT; ++dir) {
+            int next = pilot->neighbors[cell][dir];
+            if (WasReached(pilot, next) || SnakeIsOccupied(state, next)) {
+                continue;
+            }
+            pilot->visited[next] = pilot->field;
+            distance[next] = distance[cell] + 1;
+            queue[last++] = next;
+        }
+    }
+
+    pilot->fieldApple = state->apple;
+}
+
+SnakeAutopilot CreateSnakeAutopilot(void) {
+    SnakeAutopilot pilot = {0};
+    int order[GRID_CELLS];
+    int count = 0;
+
+    // row 0 left to right, the other rows zigzag without column 0 and the cycle closes
+    // going up column 0. The snake starts on row 0 heading right, already in order.
+    for (int x = 0; x < GRID_COLUMNS; ++x) {
+        order[count++] = x;
+    }
+    for (int y = 1; y < GRID_ROWS; ++y) {
+        for (int i = 1; i < GRID_COLUMNS; ++i) {
+            int x = y % 2 == 1 ? GRID_COLUMNS - i : i;
+            order[count++] = y * GRID_COLUMNS + x;
+        }
+    }
+    for (int y = GRID_ROWS - 1; y > 0; --y) {
+        order[count++] = y * GRID_COLUMNS;
+    }
+
+    for (int i = 0; i < GRID_CELLS; ++i) {
+        pilot.cycleNext[order[i]] = order[(i + 1) % GRID_CELLS];
+        pilot.cycleIndex[order[i]] = i;
+        for (Direction dir = DIR_UP; dir < DIR_COUNT; ++dir) {
+            pilot.neighbors[i][dir] = NeighborCell(i, dir);
+        }
+    }
+
+    ResetSnakeAutopilot(&pilot);
+
+    return pilot;
+}
+
+void ResetSnakeAutopilot(SnakeAutopilot *pilot) { pilot->fieldApple = -1; }
+
+Direction SnakeAutopilotStep(SnakeAutopilot *pilot, const SnakeState *state) {
+    int head = SnakeHead(state);
+    int best = pilot->cycleNext[head];
+
+    // shortcuts leave gaps in the body, once the board is half full the snake sticks
+    // to the cycle so the free cells stay in one stretch ahead of it
+    if (state->apple >= 0 && 2 * state->length < GRID_CELLS) {
+        if (pilot->fieldApple != state->apple) {
+            FillDistance(pilot, state);
+        }
+
+        // tail reachability: a move may skip ahead on the cycle but never past the
+        // tail, and never past the apple either
+        int tailDistance = CycleDistance(pilot, head, SnakeBodyCell(state, 0));
+        int appleDistance = CycleDistance(pilot, head, state->apple);
+        int maxSkip = tailDistance - 1;
+        maxSkip = appleDistance < maxSkip ? appleDistance : maxSkip;
+
+        int bestDistance = WasReached(pilot, best) ? pilot->distance[best] : INT_MAX;
+        for (Direction dir = DIR_UP; dir < DIR_COUNT; ++dir) {
+            int cell = pilot->neighbors[head][dir];
+            int skip = CycleDistance(pilot, head, cell);
+            if (skip < 1 || skip > maxSkip || !WasReached(pilot, cell) ||
+                SnakeIsOccupied(state, cell)) {
+                continue;
+            }
+            if (pilot->distance[cell] < bestDistance) {
+                best = cell;
+                bestDistance = pilot->distance[cell];
+            }
+        }
+    }
+
+    for (Direction dir = DIR_UP; dir < DIR_COUNT; ++dir) {
+        if (pilot->neighbors[head][dir] == best) {
+            return dir;
+        }
+    }
+    return state->moveDir;
+}
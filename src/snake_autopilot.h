@@ -0,0 +1,34 @@
+#ifndef SNAKE_AUTOPILOT_H
+#define SNAKE_AUTOPILOT_H
+
+#include "snake_sim.h"
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+// Chooses the snake direction every step. The body is kept in the order of a
+// Hamiltonian cycle of the board, so the cells ahead of the head up to the tail are
+// always free and following the cycle always reaches the tail. Moves that skip ahead
+// on the cycle without passing the tail are shortcuts, picked with a breadth first
+// distance field from the apple. Every buffer is sized for the board and reused.
+typedef struct SnakeAutopilot {
+    int neighbors[GRID_CELLS][DIR_COUNT]; // cell reached in every direction, wrapped
+    int cycleNext[GRID_CELLS];            // next cell along the Hamiltonian cycle
+    int cycleIndex[GRID_CELLS];           // position of every cell along the cycle
+
+    // distance field, filled once per apple
+    int fieldApple;
+    int distance[GRID_CELLS];
+    unsigned int visited[GRID_CELLS]; // field that last reached every cell
+    unsigned int field;
+    int queue[GRID_CELLS];
+} SnakeAutopilot;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+SnakeAutopilot CreateSnakeAutopilot(void);
+void ResetSnakeAutopilot(SnakeAutopilot *pilot);
+Direction SnakeAutopilotStep(SnakeAutopilot *pilot, const SnakeState *state);
+
+#endif // SNAKE_AUTOPILOT_H
@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "snake_autopilot.h"
+#include "snake_sim.h"
+#include "tick.h"
+
+// Simulation constants
+#define DEFAULT_GAMES 1000
+
+// A game ends when the autopilot goes this many steps without eating
+#define STALL_STEPS (4 * GRID_CELLS)
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+
+// -------------------------------------------------------------------------------------
+// Entrypoint
+// -------------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+    int games = DEFAULT_GAMES;
+    unsigned int seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+            games = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--games N] [--seed S]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    SnakeState state = CreateSnakeState(seed);
+    SnakeAutopilot *pilot = malloc(sizeof(SnakeAutopilot));
+    if (state.body == NULL || pilot == NULL) {
+        fprintf(stderr, "can't allocate the snake\n");
+        DestroySnakeState(&state);
+        free(pilot);
+        return 1;
+    }
+    *pilot = CreateSnakeAutopilot();
+    long long totalSteps = 0, totalLength = 0;
+    int wins = 0, deaths = 0, stalls = 0;
+    int minLength = GRID_CELLS, maxLength = 0;
+
+    double start = GetSeconds();
+    for (int game = 0; game < games; ++game) {
+        SnakeInit(&state, seed + game);
+        ResetSnakeAutopilot(pilot);
+
+        int steps = 0, hungry = 0;
+        while (true) {
+            state.dir = SnakeAutopilotStep(pilot, &state);
+            SnakeStep(&state);
+            ++steps;
+
+            if (state.events & SNAKE_EVENT_WIN) {
+                ++wins;
+                break;
+            } else if (state.events & SNAKE_EVENT_DEAD) {
+                ++deaths;
+                break;
+            } else if (state.events & SNAKE_EVENT_EAT) {
+                hungry = 0;
+            } else if (++hungry > STALL_STEPS) {
+                ++stalls;
+                break;
+            }
+        }
+
+        totalSteps += steps;
+        totalLength += state.length;
+        minLength = state.length < minLength ? state.length : minLength;
+        maxLength = state.length > maxLength ? state.length : maxLength;
+    }
+    double elapsed = GetSeconds() - start;
+
+    DestroySnakeState(&state);
+    free(pilot);
+
+    printf("games:      %d (won %d, died %d, stalled %d)\n", games, wins, deaths,
+           stalls);
+    printf("length:     mean %.1f, min %d, max %d of %d\n",
+           games > 0 ? (double)totalLength / games : 0.0, minLength, maxLength,
+           GRID_CELLS);
+    printf("steps:      %lld\n", totalSteps);
+    printf("elapsed:    %.3f s (%.2f ms/game)\n", elapsed,
+           games > 0 ? 1000.0 * elapsed / games : 0.0);
+    printf("steps/s:    %.0f\n", elapsed > 0.0 ? totalSteps / elapsed : 0.0);
+
+    return 0;
+}
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
@@ -0,0 +1,177 @@
+#include "snake_sim.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const int dirX[] = {0, 0, 1, 0, -1};
+static const int dirY[] = {0, -1, 0, 1, 0};
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static void OccupyCell(SnakeState *state, int cell) {
+    state->occupied[cell / 32] |= 1u << (cell % 32);
+
+    // swap-remove the cell from the free list
+    int slot = state->freeSlot[cell];
+    int last = state->freeCells[--state->freeCount];
+    state->freeCells[slot] = last;
+    state->freeSlot[last] = slot;
+    state->freeSlot[cell] = -1;
+}
+
+static void ReleaseCell(SnakeState *state, int cell) {
+    state->occupied[cell / 32] &= ~(1u << (cell % 32));
+
+    state->freeSlot[cell] = state->freeCount;
+    state->freeCells[state->freeCount++] = cell;
+}
+
+static bool GrowBody(SnakeState *state) {
+    // unwrap the ring into a buffer twice as big, the old one is kept without memory
+    int *body = malloc(2 * state->capacity * sizeof(int));
+    if (body == NULL) {
+        return false;
+    }
+    for (int i = 0; i < state->length; ++i) {
+        body[i] = SnakeBodyCell(state, i);
+    }
+    free(state->body);
+    state->body = body;
+    state->capacity *= 2;
+    state->tail = 0;
+    return true;
+}
+
+static void PushHead(SnakeState *state, int cell) {
+    // the ring has room, it only grows when the snake eats
+    state->body[(state->tail + state->length++) % state->capacity] = cell;
+    OccupyCell(state, cell);
+}
+
+static void PopTail(SnakeState *state) {
+    int cell = state->body[state->tail];
+    state->tail = (state->tail + 1) % state->capacity;
+    --state->length;
+    ReleaseCell(state, cell);
+}
+
+static int GeneratePoint(SnakeState *state) {
+    if (state->freeCount == 0) {
+        return -1;
+    }
+    return state->freeCells[SnakeRandomValue(state, 0, state->freeCount - 1)];
+}
+
+SnakeState CreateSnakeState(unsigned int seed) {
+    SnakeState state = {0};
+    state.body = malloc(SNAKE_INITIAL_CAPACITY * sizeof(int));
+    if (state.body != NULL) {
+        state.capacity = SNAKE_INITIAL_CAPACITY;
+        SnakeInit(&state, seed);
+    }
+    return state;
+}
+
+void DestroySnakeState(SnakeState *state) {
+    free(state->body);
+    state->body = NULL;
+    state->capacity = 0;
+}
+
+void SnakeInit(SnakeState *state, unsigned int seed) {
+    // the body buffer is kept, it only grows
+    state->rngState = seed != 0 ? seed : 0x9e3779b9u;
+    state->length = 0;
+    state->tail = 0;
+    memset(state->occupied, 0, sizeof(state->occupied));
+    for (int cell = 0; cell < GRID_CELLS; ++cell) {
+        state->freeCells[cell] = cell;
+        state->freeSlot[cell] = cell;
+    }
+    state->freeCount = GRID_CELLS;
+
+    for (int x = 0; x < 3; ++x) {
+        PushHead(state, x);
+    }
+    state->speed = 5;
+    state->dir = DIR_RIGHT;
+    state->moveDir = DIR_RIGHT;
+    state->prevHead = SnakeHead(state);
+    state->prevTail = state->body[state->tail];
+    state->events = SNAKE_EVENT_NONE;
+
+    state->apple = GeneratePoint(state);
+}
+
+void SnakeStep(SnakeState *state) {
+    state->events = SNAKE_EVENT_NONE;
+    state->prevHead = SnakeHead(state);
+    state->prevTail = state->body[state->tail];
+
+    // the snake can't turn back onto its own neck
+    Direction dir = state->dir;
+    if (dir == DIR_NONE || (dirX[dir] == -dirX[state->moveDir] &&
+                            dirY[dir] == -dirY[state->moveDir])) {
+        dir = state->moveDir;
+    }
+    state->moveDir = dir;
+
+    // New head, wrapping around the board edges
+    int x = (state->prevHead % GRID_COLUMNS + dirX[dir] + GRID_COLUMNS) % GRID_COLUMNS;
+    int y = (state->prevHead / GRID_COLUMNS + dirY[dir] + GRID_ROWS) % GRID_ROWS;
+    int head = y * GRID_COLUMNS + x;
+
+    // the head may take the cell the tail leaves in this same step
+    bool eat = head == state->apple;
+    if (SnakeIsOccupied(state, head) && (eat || head != state->prevTail)) {
+        state->events |= SNAKE_EVENT_DEAD;
+        return;
+    }
+
+    // a full ring grows before the snake moves, the game ends here if it can't
+    if (eat && state->length == state->capacity && !GrowBody(state)) {
+        state->events |= SNAKE_EVENT_DEAD | SNAKE_EVENT_NO_MEMORY;
+        return;
+    }
+
+    if (!eat) {
+        PopTail(state);
+    }
+    PushHead(state, head);
+
+    // eat apple
+    if (eat) {
+        state->apple = GeneratePoint(state);
+        state->speed = fminf(state->speed * 1.1f, SNAKE_SPEED_MAX);
+        state->events |= SNAKE_EVENT_EAT;
+        if (state->apple < 0) {
+            state->events |= SNAKE_EVENT_WIN;
+        }
+    }
+}
+
+int SnakeBodyCell(const SnakeState *state, int index) {
+    // index 0 is the tail
+    return state->body[(state->tail + index) % state->capacity];
+}
+
+int SnakeHead(const SnakeState *state) {
+    return SnakeBodyCell(state, state->length - 1);
+}
+
+bool SnakeIsOccupied(const SnakeState *state, int cell) {
+    return (state->occupied[cell / 32] >> (cell % 32)) & 1u;
+}
+
+int SnakeRandomValue(SnakeState *state, int min, int max) {
+    // xorshift32, kept in the state so games are reproducible from the seed
+    unsigned int x = state->rngState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state->rngState = x;
+
+    return min + (int)(x % (unsigned int)(max - min + 1));
+}
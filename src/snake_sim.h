@@ -0,0 +1,80 @@
+#ifndef SNAKE_SIM_H
+#define SNAKE_SIM_H
+
+#include <stdbool.h>
+
+// Arena constants
+#define SCREEN_WIDTH  800
+#define SCREEN_HEIGHT 600
+
+#define GRID_WIDTH   20
+#define GRID_HEIGHT  20
+#define GRID_COLUMNS (SCREEN_WIDTH / GRID_WIDTH)
+#define GRID_ROWS    (SCREEN_HEIGHT / GRID_HEIGHT)
+#define GRID_CELLS   (GRID_COLUMNS * GRID_ROWS)
+
+// Body cells allocated up front, the ring doubles when the snake outgrows it
+#define SNAKE_INITIAL_CAPACITY 32
+
+// Blocks per second, every apple speeds the snake up to this, two steps a frame at
+// 60 fps
+#define SNAKE_SPEED_MAX 120.0f
+
+// -------------------------------------------------------------------------------------
+// Enumerations
+// -------------------------------------------------------------------------------------
+typedef enum {
+    DIR_NONE = 0,
+    DIR_UP,
+    DIR_RIGHT,
+    DIR_DOWN,
+    DIR_LEFT,
+    DIR_COUNT
+} Direction;
+
+// Events raised by the last SnakeStep
+typedef enum {
+    SNAKE_EVENT_NONE = 0,
+    SNAKE_EVENT_EAT = 1 << 0,
+    SNAKE_EVENT_DEAD = 1 << 1,     // the head ran into the body
+    SNAKE_EVENT_WIN = 1 << 2,      // the body fills the whole board
+    SNAKE_EVENT_NO_MEMORY = 1 << 3 // with dead, the body couldn't grow to eat
+} SnakeEvent;
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+// Cells are indexed row by row, cell = y * GRID_COLUMNS + x. The body is a ring from
+// tail to head, every cell outside it is kept in freeCells so the apple can be
+// placed in O(1) however full the board is. A state created without memory for the
+// body has it NULL and can't be played.
+typedef struct SnakeState {
+    int *body;
+    int capacity, length, tail;
+    unsigned int occupied[(GRID_CELLS + 31) / 32]; // body cells bitmap
+
+    int freeCells[GRID_CELLS]; // cells outside the body, in no particular order
+    int freeSlot[GRID_CELLS];  // index of every cell in freeCells, -1 if in the body
+    int freeCount;
+
+    int apple;              // cell, -1 once the board is full
+    float speed;            // blocks per second
+    Direction dir, moveDir; // requested and last moved direction
+    int prevHead, prevTail; // cells before the last step, for interpolation
+    unsigned int rngState;
+    unsigned int events; // SnakeEvent flags raised by the last step
+} SnakeState;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+SnakeState CreateSnakeState(unsigned int seed);
+void DestroySnakeState(SnakeState *state);
+void SnakeInit(SnakeState *state, unsigned int seed);
+void SnakeStep(SnakeState *state);
+int SnakeBodyCell(const SnakeState *state, int index);
+int SnakeHead(const SnakeState *state);
+bool SnakeIsOccupied(const SnakeState *state, int cell);
+int SnakeRandomValue(SnakeState *state, int min, int max);
+
+#endif // SNAKE_SIM_H
@@ -0,0 +1,46 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "tick.h"
+
+#include <math.h>
+#include <time.h>
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+TickClock CreateTickClock(int maxTicks) {
+    TickClock clock = {.accumulator = 0.0f, .maxTicks = maxTicks, .ticks = 0};
+    return clock;
+}
+
+void TickClockAdvance(TickClock *clock, float dt) {
+    clock->accumulator += dt;
+    clock->ticks = 0;
+}
+
+bool TickClockConsume(TickClock *clock, float step) {
+    if (clock->accumulator < step) {
+        return false;
+    }
+
+    if (clock->ticks >= clock->maxTicks) {
+        // too far behind, drop the backlog instead of spiraling
+        clock->accumulator = fmodf(clock->accumulator, step);
+        return false;
+    }
+
+    clock->accumulator -= step;
+    ++clock->ticks;
+    return true;
+}
+
+float TickClockAlpha(const TickClock *clock, float step) {
+    float alpha = clock->accumulator / step;
+    return alpha < 1.0f ? alpha : 1.0f;
+}
+
+double GetSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
@@ -0,0 +1,25 @@
+#ifndef TICK_H
+#define TICK_H
+
+#include <stdbool.h>
+
+// Fixed timestep accumulator: the frame time is banked and spent in fixed ticks,
+// so simulation results don't depend on the frame rate
+typedef struct TickClock {
+    float accumulator; // frame time not simulated yet
+    int maxTicks;      // ticks allowed per frame before dropping the backlog
+    int ticks;         // ticks consumed in the current frame
+} TickClock;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+TickClock CreateTickClock(int maxTicks);
+void TickClockAdvance(TickClock *clock, float dt);
+bool TickClockConsume(TickClock *clock, float step);
+float TickClockAlpha(const TickClock *clock, float step);
+
+// Seconds on the monotonic clock from an arbitrary start, with or without a window
+double GetSeconds(void);
+
+#endif // TICK_H
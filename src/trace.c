@@ -0,0 +1,158 @@
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tick.h"
+
+// -------------------------------------------------------------------------------------
+// Globals
+// -------------------------------------------------------------------------------------
+static const char *tracePath;
+static bool traceEnabled;
+static double traceStart;
+
+// every thread that recorded an event, pushed lock-free on its first one
+static TraceBuffer *traceBuffers;
+static int traceThreads;
+static __thread TraceBuffer *threadBuffer;
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static TraceBuffer *ThreadBuffer(void) {
+    if (threadBuffer != NULL) {
+        return threadBuffer;
+    }
+
+    TraceBuffer *buffer = calloc(1, sizeof(TraceBuffer));
+    if (buffer == NULL) {
+        return NULL;
+    }
+    buffer->threadId = __atomic_add_fetch(&traceThreads, 1, __ATOMIC_RELAXED);
+    buffer->next = __atomic_load_n(&traceBuffers, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&traceBuffers, &buffer->next, buffer, true,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+
+    threadBuffer = buffer;
+    return buffer;
+}
+
+static void TraceAppend(const char *name) {
+    TraceBuffer *buffer = ThreadBuffer();
+    if (buffer == NULL) {
+        return;
+    }
+
+    unsigned int index = buffer->count % TRACE_CHUNK_EVENTS;
+    if (index == 0) {
+        TraceChunk *chunk = malloc(sizeof(TraceChunk));
+        if (chunk == NULL) {
+            return;
+        }
+        chunk->next = NULL;
+        if (buffer->last != NULL) {
+            buffer->last->next = chunk;
+        } else {
+            buffer->first = chunk;
+        }
+        buffer->last = chunk;
+    }
+
+    buffer->last->events[index] =
+        (TraceEvent){.name = name, .time = 1e6 * (GetSeconds() - traceStart)};
+    __atomic_store_n(&buffer->count, buffer->count + 1, __ATOMIC_RELEASE);
+}
+
+bool InitTrace(const char *path) {
+#if defined(TRACE_ZONES)
+    tracePath = path;
+    traceStart = GetSeconds();
+    traceEnabled = true;
+#else
+    (void)path;
+#endif
+    return traceEnabled;
+}
+
+bool CloseTrace(void) {
+    // the other threads must be done by now, their buffers are freed
+    if (!traceEnabled) {
+        return false;
+    }
+    traceEnabled = false;
+
+    FILE *file = fopen(tracePath, "w");
+    if (file != NULL) {
+        // Chrome trace event format, opens in ui.perfetto.dev and chrome://tracing
+        fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        const char *separator = "";
+
+        TraceBuffer *buffer = __atomic_load_n(&traceBuffers, __ATOMIC_ACQUIRE);
+        for (; buffer != NULL; buffer = buffer->next) {
+            if (buffer->threadName != NULL) {
+                fprintf(file,
+                        "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                        "\"args\":{\"name\":\"%s\"}}",
+                        separator, buffer->threadId, buffer->threadName);
+                separator = ",\n";
+            }
+
+            unsigned int count = __atomic_load_n(&buffer->count, __ATOMIC_ACQUIRE);
+            TraceChunk *chunk = buffer->first;
+            for (unsigned int i = 0; i < count; ++i) {
+                if (i > 0 && i % TRACE_CHUNK_EVENTS == 0) {
+                    chunk = chunk->next;
+                }
+                TraceEvent *event = &chunk->events[i % TRACE_CHUNK_EVENTS];
+                if (event->name != NULL) {
+                    fprintf(file,
+                            "%s{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":1,"
+                            "\"tid\":%d}",
+                            separator, event->name, event->time, buffer->threadId);
+                } else {
+                    fprintf(file, "%s{\"ph\":\"E\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+                            separator, event->time, buffer->threadId);
+                }
+                separator = ",\n";
+            }
+        }
+
+        fprintf(file, "\n]}\n");
+        fclose(file);
+    }
+
+    while (traceBuffers != NULL) {
+        TraceBuffer *buffer = traceBuffers;
+        traceBuffers = buffer->next;
+        while (buffer->first != NULL) {
+            TraceChunk *chunk = buffer->first;
+            buffer->first = chunk->next;
+            free(chunk);
+        }
+        free(buffer);
+    }
+    threadBuffer = NULL;
+
+    return file != NULL;
+}
+
+void TraceZoneBegin(const char *name) {
+    if (traceEnabled) {
+        TraceAppend(name);
+    }
+}
+
+void TraceZoneEnd(void) {
+    if (traceEnabled) {
+        TraceAppend(NULL);
+    }
+}
+
+void TraceThreadName(const char *name) {
+    TraceBuffer *buffer = traceEnabled ? ThreadBuffer() : NULL;
+    if (buffer != NULL) {
+        buffer->threadName = name;
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+
+// Events per buffer chunk, a thread chains another chunk once one is full
+#define TRACE_CHUNK_EVENTS 16384
+
+// Profiling zones, only compiled in with TRACE_ZONES defined (make TRACE=1). Every
+// TRACE_BEGIN needs its TRACE_END on the same thread and names are string literals.
+#if defined(TRACE_ZONES)
+#define TRACE_BEGIN(name)  TraceZoneBegin(name)
+#define TRACE_END()        TraceZoneEnd()
+#define TRACE_THREAD(name) TraceThreadName(name)
+#else
+#define TRACE_BEGIN(name)  ((void)0)
+#define TRACE_END()        ((void)0)
+#define TRACE_THREAD(name) ((void)0)
+#endif
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+typedef struct TraceEvent {
+    const char *name; // NULL ends the innermost zone
+    double time;      // microseconds since InitTrace
+} TraceEvent;
+
+typedef struct TraceChunk {
+    TraceEvent events[TRACE_CHUNK_EVENTS];
+    struct TraceChunk *next;
+} TraceChunk;
+
+// Events of one thread, nothing is shared while they are recorded. Only the thread
+// itself appends and it publishes count with a release store.
+typedef struct TraceBuffer {
+    TraceChunk *first, *last;
+    unsigned int count;
+    int threadId;
+    const char *threadName;
+    struct TraceBuffer *next;
+} TraceBuffer;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+bool InitTrace(const char *path);
+bool CloseTrace(void);
+void TraceZoneBegin(const char *name);
+void TraceZoneEnd(void);
+void TraceThreadName(const char *name);
+
+#endif // TRACE_H
@@ -0,0 +1,254 @@
+#include "video.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "tick.h"
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static void PackY4M(const VideoWriter *writer, const Raster *frame,
+                    unsigned char *out) {
+    // BT.601 studio range, chroma from the average of every 2x2 block. The games are
+    // mostly flat colors, a block like the one on its left reuses its values.
+    int width = writer->width, height = writer->height;
+    unsigned char *y = out;
+    unsigned char *u = y + width * height;
+    unsigned char *v = u + (width / 2) * (height / 2);
+
+    for (int row = 0; row < height; row += 2) {
+        const Color *top = &frame->pixels[row * width];
+        const Color *bottom = top + width;
+        unsigned char *yTop = &y[row * width], *yBottom = yTop + width;
+        for (int col = 0; col < width; col += 2) {
+            if (col > 0 && memcmp(&top[col], &top[col - 2], 2 * sizeof(Color)) == 0 &&
+                memcmp(&bottom[col], &bottom[col - 2], 2 * sizeof(Color)) == 0) {
+                memcpy(&yTop[col], &yTop[col - 2], 2);
+                memcpy(&yBottom[col], &yBottom[col - 2], 2);
+                *u = u[-1];
+                *v = v[-1];
+                ++u;
+                ++v;
+                continue;
+            }
+
+            Color block[4] = {top[col], top[col + 1], bottom[col], bottom[col + 1]};
+            unsigned char *luma[4] = {&yTop[col], &yTop[col + 1], &yBottom[col],
+                                      &yBottom[col + 1]};
+            int r = 0, g = 0, b = 0;
+            for (int i = 0; i < 4; ++i) {
+                *luma[i] = ((66 * block[i].r + 129 * block[i].g + 25 * block[i].b +
+                             128) >> 8) + 16;
+                r += block[i].r;
+                g += block[i].g;
+                b += block[i].b;
+            }
+            // the sums are four times the average, the shift takes it back out
+            *u++ = ((-38 * r - 74 * g + 112 * b + 512) >> 10) + 128;
+            *v++ = ((112 * r - 94 * g - 18 * b + 512) >> 10) + 128;
+        }
+    }
+}
+
+static void PackPPM(const VideoWriter *writer, const Raster *frame,
+                    unsigned char *out) {
+    for (int i = 0; i < writer->width * writer->height; ++i) {
+        Color pixel = frame->pixels[i];
+        *out++ = pixel.r;
+        *out++ = pixel.g;
+        *out++ = pixel.b;
+    }
+}
+
+static bool WriteBuffer(VideoWriter *writer) {
+    bool written = fwrite(writer->buffer, 1, writer->bufferUsed, writer->file) ==
+                   writer->bufferUsed;
+    writer->bytes += writer->bufferUsed;
+    return written;
+}
+
+static void *EncoderMain(void *arg) {
+    VideoWriter *writer = arg;
+
+    pthread_mutex_lock(&writer->lock);
+    for (;;) {
+        while (writer->running && writer->encodedCount == writer->submittedCount) {
+            pthread_cond_wait(&writer->submitted, &writer->lock);
+        }
+        if (writer->encodedCount == writer->submittedCount) {
+            break; // stopped, and every frame is converted
+        }
+        const Raster *frame =
+            &writer->frames[writer->encodedCount % VIDEO_FRAMES_IN_FLIGHT];
+        bool failed = writer->failed;
+        pthread_mutex_unlock(&writer->lock);
+
+        // the raster goes back to the renderer as soon as it is converted, a full
+        // buffer is written while the next frames are drawn
+        double start = GetSeconds();
+        unsigned char *out = writer->buffer + writer->bufferUsed;
+        memcpy(out, writer->header, writer->headerSize);
+        if (writer->format == VIDEO_Y4M) {
+            PackY4M(writer, frame, out + writer->headerSize);
+        } else {
+            PackPPM(writer, frame, out + writer->headerSize);
+        }
+        writer->bufferUsed += writer->frameSize;
+
+        pthread_mutex_lock(&writer->lock);
+        ++writer->encodedCount;
+        pthread_cond_signal(&writer->released);
+        pthread_mutex_unlock(&writer->lock);
+
+        if (writer->bufferUsed + writer->frameSize > writer->bufferSize) {
+            failed = failed || !WriteBuffer(writer);
+            writer->bufferUsed = 0;
+        }
+        writer->encodeTime += GetSeconds() - start;
+
+        pthread_mutex_lock(&writer->lock);
+        writer->failed = failed;
+    }
+    if (!writer->failed && writer->bufferUsed > 0) {
+        writer->failed = !WriteBuffer(writer);
+    }
+    pthread_mutex_unlock(&writer->lock);
+
+    return NULL;
+}
+
+VideoWriter CreateVideoWriter(const char *path, VideoFormat format, int width,
+                              int height, int fps) {
+    VideoWriter writer = {0};
+    writer.format = format;
+    writer.width = width;
+    writer.height = height;
+    writer.fps = fps;
+
+    // "-" is stdout, the stream goes straight into a pipe
+    writer.file = strcmp(path, "-") == 0 ? stdout : fopen(path, "wb");
+    if (writer.file == NULL) {
+        return writer;
+    }
+
+    // Y4M has a stream header and a marker per frame, every PPM has its own header
+    size_t pixelsSize;
+    if (format == VIDEO_Y4M) {
+        fprintf(writer.file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width,
+                height, fps);
+        snprintf(writer.header, sizeof(writer.header), "FRAME\n");
+        pixelsSize = (size_t)width * height * 3 / 2;
+    } else {
+        snprintf(writer.header, sizeof(writer.header), "P6\n%d %d\n255\n", width,
+                 height);
+        pixelsSize = (size_t)width * height * 3;
+    }
+    writer.headerSize = strlen(writer.header);
+    writer.frameSize = writer.headerSize + pixelsSize;
+
+    // whole frames only, at least one
+    int bufferFrames = VIDEO_BUFFER_SIZE / writer.frameSize;
+    writer.bufferSize = writer.frameSize * (bufferFrames > 1 ? bufferFrames : 1);
+    writer.buffer = malloc(writer.bufferSize);
+    bool created = writer.buffer != NULL;
+
+    for (int i = 0; i < VIDEO_FRAMES_IN_FLIGHT; ++i) {
+        writer.frames[i] = CreateRaster(width, height);
+        created = created && writer.frames[i].pixels != NULL;
+    }
+
+    // closed again without the memory, the writer never starts
+    if (!created) {
+        DestroyVideoWriter(&writer);
+    }
+    return writer;
+}
+
+bool StartVideoWriter(VideoWriter *writer) {
+    if (writer->file == NULL) {
+        return false;
+    }
+
+    pthread_mutex_init(&writer->lock, NULL);
+    pthread_cond_init(&writer->submitted, NULL);
+    pthread_cond_init(&writer->released, NULL);
+    writer->startTime = GetSeconds();
+    writer->running = true;
+    if (pthread_create(&writer->thread, NULL, EncoderMain, writer) != 0) {
+        writer->running = false;
+    }
+    return writer->running;
+}
+
+bool DestroyVideoWriter(VideoWriter *writer) {
+    // the encoder drains the frames already submitted before it stops
+    if (writer->running) {
+        pthread_mutex_lock(&writer->lock);
+        writer->running = false;
+        pthread_cond_signal(&writer->submitted);
+        pthread_mutex_unlock(&writer->lock);
+        pthread_join(writer->thread, NULL);
+        writer->elapsed = GetSeconds() - writer->startTime;
+
+        pthread_cond_destroy(&writer->submitted);
+        pthread_cond_destroy(&writer->released);
+        pthread_mutex_destroy(&writer->lock);
+    }
+
+    if (writer->file != NULL) {
+        bool closed = writer->file == stdout ? fflush(writer->file) == 0
+                                             : fclose(writer->file) == 0;
+        writer->failed = writer->failed || !closed;
+        writer->file = NULL;
+    }
+    for (int i = 0; i < VIDEO_FRAMES_IN_FLIGHT; ++i) {
+        DestroyRaster(&writer->frames[i]);
+    }
+    free(writer->buffer);
+    writer->buffer = NULL;
+
+    return !writer->failed;
+}
+
+Raster *VideoWriterAcquire(VideoWriter *writer) {
+    if (!writer->running) {
+        return NULL;
+    }
+
+    // the ring is full until the encoder gives the oldest frame back
+    pthread_mutex_lock(&writer->lock);
+    while (writer->submittedCount - writer->encodedCount == VIDEO_FRAMES_IN_FLIGHT) {
+        pthread_cond_wait(&writer->released, &writer->lock);
+    }
+    bool failed = writer->failed;
+    pthread_mutex_unlock(&writer->lock);
+
+    return failed ? NULL
+                  : &writer->frames[writer->submittedCount % VIDEO_FRAMES_IN_FLIGHT];
+}
+
+void VideoWriterSubmit(VideoWriter *writer) {
+    if (!writer->running) {
+        return;
+    }
+
+    pthread_mutex_lock(&writer->lock);
+    ++writer->submittedCount;
+    pthread_cond_signal(&writer->submitted);
+    pthread_mutex_unlock(&writer->lock);
+}
+
+void VideoWriterReport(const VideoWriter *writer) {
+    // on stderr, stdout may be the stream itself
+    int frames = writer->encodedCount;
+    double fps = writer->elapsed > 0.0 ? frames / writer->elapsed : 0.0;
+    fprintf(stderr,
+            "video: %d frames (%.1f s) in %.2f s, %.0f frames/s, %.1fx realtime\n",
+            frames, (double)frames / writer->fps, writer->elapsed, fps,
+            fps / writer->fps);
+    fprintf(stderr, "video: %.1f MB written, encoder busy %.0f%% of the time\n",
+            writer->bytes / 1e6,
+            writer->elapsed > 0.0 ? 100.0 * writer->encodeTime / writer->elapsed
+                                  : 0.0);
+}
@@ -0,0 +1,64 @@
+#ifndef VIDEO_H
+#define VIDEO_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "raster.h"
+
+// Frames rendered ahead of the encoder, and the converted frames it writes at once
+#define VIDEO_FRAMES_IN_FLIGHT 4
+#define VIDEO_BUFFER_SIZE      (4 << 20)
+
+// -------------------------------------------------------------------------------------
+// Enumerations
+// -------------------------------------------------------------------------------------
+typedef enum {
+    VIDEO_Y4M = 0, // YUV 4:2:0 planes, what ffmpeg and most players read raw
+    VIDEO_PPM      // one binary PPM after the other, for ffmpeg -f image2pipe
+} VideoFormat;
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+// Raw video stream, encoded on its own thread while the next frames are rendered.
+// The frames are a ring of CPU rasters reused for the whole stream: the renderer
+// acquires the next free one, draws into it and submits it, the encoder converts
+// it into the output buffer and hands it back. The buffer is written once it holds
+// no room for another frame, a few megabytes per call. A writer whose file can't be
+// opened or whose memory can't be allocated is created closed and never starts.
+typedef struct VideoWriter {
+    FILE *file;
+    VideoFormat format;
+    int width, height, fps;
+    Raster frames[VIDEO_FRAMES_IN_FLIGHT];
+    char header[32]; // in front of every frame
+    size_t headerSize, frameSize;
+    unsigned char *buffer; // converted frames waiting to be written
+    size_t bufferSize, bufferUsed;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t submitted, released;
+    bool running, failed;
+    int submittedCount, encodedCount; // frames handed over and given back
+
+    // encoder side
+    double encodeTime; // seconds spent converting and writing
+    long long bytes;
+    double startTime, elapsed; // of the whole stream, once destroyed
+} VideoWriter;
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+VideoWriter CreateVideoWriter(const char *path, VideoFormat format, int width,
+                              int height, int fps);
+bool StartVideoWriter(VideoWriter *writer);
+bool DestroyVideoWriter(VideoWriter *writer);
+Raster *VideoWriterAcquire(VideoWriter *writer);
+void VideoWriterSubmit(VideoWriter *writer);
+void VideoWriterReport(const VideoWriter *writer);
+
+#endif // VIDEO_H
@@ -0,0 +1,153 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "work_pool.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Keeps queues of different workers on different cache lines
+#define CACHE_LINE_SIZE 64
+
+// -------------------------------------------------------------------------------------
+// Structs
+// -------------------------------------------------------------------------------------
+// Slice of the index range owned by a worker, the owner pops from the front and
+// thieves take half of what is left from the back
+typedef struct WorkQueue {
+    pthread_mutex_t lock;
+    int begin, end;
+    char padding[CACHE_LINE_SIZE];
+} WorkQueue;
+
+typedef struct WorkPool {
+    WorkQueue *queues;
+    int workerCount;
+    WorkFunc func;
+    void *context;
+} WorkPool;
+
+typedef struct Worker {
+    WorkPool *pool;
+    int id;
+} Worker;
+
+// -------------------------------------------------------------------------------------
+// Module implementation
+// -------------------------------------------------------------------------------------
+static bool PopWork(WorkQueue *queue, int *index) {
+    bool found = false;
+
+    pthread_mutex_lock(&queue->lock);
+    if (queue->begin < queue->end) {
+        *index = queue->begin++;
+        found = true;
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return found;
+}
+
+static bool StealWork(WorkPool *pool, int thief) {
+    for (int i = 1; i < pool->workerCount; ++i) {
+        WorkQueue *victim = &pool->queues[(thief + i) % pool->workerCount];
+        int begin = 0, end = 0;
+
+        pthread_mutex_lock(&victim->lock);
+        int remaining = victim->end - victim->begin;
+        if (remaining > 0) {
+            end = victim->end;
+            begin = end - (remaining + 1) / 2;
+            victim->end = begin;
+        }
+        pthread_mutex_unlock(&victim->lock);
+
+        if (begin < end) {
+            WorkQueue *own = &pool->queues[thief];
+            pthread_mutex_lock(&own->lock);
+            own->begin = begin;
+            own->end = end;
+            pthread_mutex_unlock(&own->lock);
+            return true;
+        }
+    }
+
+    // the range is never refilled, so nothing left to steal means we are done
+    return false;
+}
+
+static void *WorkerMain(void *arg) {
+    Worker *worker = arg;
+    WorkPool *pool = worker->pool;
+    WorkQueue *queue = &pool->queues[worker->id];
+    int index;
+
+    for (;;) {
+        if (PopWork(queue, &index)) {
+            pool->func(pool->context, worker->id, index);
+        } else if (!StealWork(pool, worker->id)) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+int GetCoreCount(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+}
+
+void RunWorkPool(int count, int workerCount, WorkFunc func, void *context) {
+    if (workerCount < 1) {
+        workerCount = 1;
+    }
+
+    WorkPool pool = {.queues = calloc(workerCount, sizeof(WorkQueue)),
+                     .workerCount = workerCount,
+                     .func = func,
+                     .context = context};
+    Worker *workers = calloc(workerCount, sizeof(Worker));
+    pthread_t *threads = calloc(workerCount, sizeof(pthread_t));
+
+    // without the bookkeeping the calling thread runs the whole range alone
+    if (pool.queues == NULL || workers == NULL || threads == NULL) {
+        free(threads);
+        free(workers);
+        free(pool.queues);
+        for (int i = 0; i < count; ++i) {
+            func(context, 0, i);
+        }
+        return;
+    }
+
+    // split the range evenly, stealing takes care of the imbalance
+    for (int i = 0; i < workerCount; ++i) {
+        pthread_mutex_init(&pool.queues[i].lock, NULL);
+        pool.queues[i].begin = (int)((long long)count * i / workerCount);
+        pool.queues[i].end = (int)((long long)count * (i + 1) / workerCount);
+        workers[i] = (Worker){.pool = &pool, .id = i};
+    }
+
+    // the calling thread is worker 0. The queues of workers that failed to start are
+    // stolen by the others like any other, only the started threads are joined
+    int started = 1;
+    for (; started < workerCount; ++started) {
+        Worker *worker = &workers[started];
+        if (pthread_create(&threads[started], NULL, WorkerMain, worker) != 0) {
+            break;
+        }
+    }
+    WorkerMain(&workers[0]);
+    for (int i = 1; i < started; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (int i = 0; i < workerCount; ++i) {
+        pthread_mutex_destroy(&pool.queues[i].lock);
+    }
+    free(threads);
+    free(workers);
+    free(pool.queues);
+}
@@ -0,0 +1,13 @@
+#ifndef WORK_POOL_H
+#define WORK_POOL_H
+
+// Job run for every index of the range, worker is in [0, workerCount)
+typedef void (*WorkFunc)(void *context, int worker, int index);
+
+// -------------------------------------------------------------------------------------
+// Module declaration
+// -------------------------------------------------------------------------------------
+int GetCoreCount(void);
+void RunWorkPool(int count, int workerCount, WorkFunc func, void *context);
+
+#endif // WORK_POOL_H